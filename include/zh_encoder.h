@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "sdkconfig.h"
 #include "esp_log.h"
 #include "driver/gpio.h"
 #include "driver/pulse_cnt.h"
@@ -11,49 +12,305 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_event.h"
+#include "nvs.h"
+
+/**
+ * @brief Maximum quantity of encoders on one device.
+ */
+#ifdef CONFIG_ZH_ENCODER_MAX_QUANTITY
+#define ZH_ENCODER_MAX_QUANTITY CONFIG_ZH_ENCODER_MAX_QUANTITY
+#else
+#define ZH_ENCODER_MAX_QUANTITY 16
+#endif
+
+/**
+ * @brief Maximum quantity of encoder processing task groups.
+ */
+#define ZH_ENCODER_MAX_TASK_GROUPS 4
+
+/**
+ * @brief Maximum quantity of tasks waiting for encoder changes at the same time.
+ */
+#define ZH_ENCODER_MAX_WAITERS 4
+
+/**
+ * @brief Maximum quantity of acceleration table entries.
+ */
+#define ZH_ENCODER_ACCELERATION_TABLE_SIZE 4
+
+/**
+ * @brief Quantity of log2 buckets in encoder latency histograms.
+ */
+#define ZH_ENCODER_LATENCY_BUCKETS 16
+
+/**
+ * @brief Maximum quantity of value mapping table breakpoints.
+ */
+#define ZH_ENCODER_MAPPING_TABLE_SIZE 8
+
+/**
+ * @brief Quantity of entries in precomputed value mapping curves.
+ */
+#define ZH_ENCODER_MAPPING_LUT_SIZE 33
 
 /**
  * @brief Encoder initial default values.
  */
 #define ZH_ENCODER_INIT_CONFIG_DEFAULT()        \
     {                                           \
+        .encoder_step = 1,                      \
+        .encoder_min_value = -10,               \
+        .encoder_max_value = 10,                \
         .task_priority = 1,                     \
-        .stack_size = configMINIMAL_STACK_SIZE, \
         .queue_size = 1,                        \
         .a_gpio_number = GPIO_NUM_MAX,          \
         .b_gpio_number = GPIO_NUM_MAX,          \
         .s_gpio_number = GPIO_NUM_MAX,          \
-        .s_gpio_debounce_time = 10,             \
         .pullup = true,                         \
-        .encoder_min_value = -10,               \
-        .encoder_max_value = 10,                \
-        .encoder_step = 1,                      \
-        .encoder_number = 0}
+        .s_gpio_debounce_time = 10,             \
+        .encoder_number = 0,                    \
+        .stack_size = configMINIMAL_STACK_SIZE, \
+        .counter_mode = false,                  \
+        .counter_high_limit = 1000,             \
+        .counter_low_limit = -1000,             \
+        .counter_event_period = 50,             \
+        .batch_mode = false,                    \
+        .batch_frame_period = 20,               \
+        .acceleration = {{0, 0}},               \
+        .event_timeout = 1000,                  \
+        .event_min_interval = 0,                \
+        .callback = NULL,                       \
+        .callback_arg = NULL,                   \
+        .isr_callback = NULL,                   \
+        .backend = ZH_ENCODER_BACKEND_PCNT,     \
+        .resolution = ZH_ENCODER_RESOLUTION_X1, \
+        .counts_per_step = 1,                   \
+        .task_core = -1,                        \
+        .button_gestures = false,               \
+        .button_active_low = true,              \
+        .button_long_press_time = 1000,         \
+        .button_double_click_time = 300,        \
+        .button_repeat_period = 0,              \
+        .glitch_filter_ns = 1000,               \
+        .hysteresis_count = 0,                  \
+        .hysteresis_window = 0,                 \
+        .persistence = false,                   \
+        .persistence_quiet_period = 2000,       \
+        .task_group = 0,                        \
+        .event_coalescing = false,              \
+        .velocity_window = 10,                  \
+        .velocity_alpha = 0,                    \
+        .velocity_beta = 0,                     \
+        .wrap_around = false,                   \
+        .mapping = ZH_ENCODER_MAPPING_LINEAR,   \
+        .mapping_min_value = 0,                 \
+        .mapping_max_value = 1,                 \
+        .mapping_curvature = 4,                 \
+        .mapping_table = {{0, 0}},              \
+        .mapping_table_size = 0,                \
+        .task_stack = NULL,                     \
+        .task_tcb = NULL,                       \
+        .event_loop = NULL,                     \
+        .z_gpio_number = GPIO_NUM_MAX,          \
+        .index_mode = ZH_ENCODER_INDEX_LATCH,   \
+        .index_position = 0,                    \
+        .index_active_low = false}
 
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
-    extern TaskHandle_t zh_encoder; /*!< Encoder Task Handle. */
+    extern TaskHandle_t zh_encoder; /*!< Encoder Task Handle. @note Processing task of task group 0. */
+
+    /**
+     * @brief Enumeration of encoder decoder backends.
+     */
+    typedef enum
+    {
+        ZH_ENCODER_BACKEND_PCNT,     /*!< Hardware pulse counter. @note One PCNT unit per encoder. */
+        ZH_ENCODER_BACKEND_SOFTWARE, /*!< GPIO interrupt state machine. @note No PCNT unit is used. Counter mode is not supported. */
+        ZH_ENCODER_BACKEND_REPLAY    /*!< No decoder. @note Input comes only from zh_encoder_trace_replay. No GPIO is configured and no isr is attached. Counter mode is not supported. */
+    } zh_encoder_backend_t;
+
+    /**
+     * @brief Enumeration of encoder counting resolutions.
+     */
+    typedef enum
+    {
+        ZH_ENCODER_RESOLUTION_X1, /*!< One count per quadrature cycle. */
+        ZH_ENCODER_RESOLUTION_X2, /*!< Two counts per quadrature cycle (both edges of A). */
+        ZH_ENCODER_RESOLUTION_X4  /*!< Four counts per quadrature cycle (both edges of A and B). */
+    } zh_encoder_resolution_t;
+
+    /**
+     * @brief Enumeration of encoder value mapping curves.
+     */
+    typedef enum
+    {
+        ZH_ENCODER_MAPPING_LINEAR, /*!< Value is equal to position. */
+        ZH_ENCODER_MAPPING_LOG,    /*!< Logarithmic curve from mapping_min_value to mapping_max_value. @note Fast change at the beginning of the range. */
+        ZH_ENCODER_MAPPING_EXP,    /*!< Exponential curve from mapping_min_value to mapping_max_value. @note Fast change at the end of the range. Use for volume, frequency and brightness. */
+        ZH_ENCODER_MAPPING_TABLE   /*!< Piecewise linear curve through the mapping table breakpoints. */
+    } zh_encoder_mapping_t;
+
+    /**
+     * @brief Structure for encoder value mapping table breakpoint.
+     */
+    typedef struct
+    {
+        float position; /*!< Encoder position. */
+        float value;    /*!< Value at the position. */
+    } zh_encoder_mapping_point_t;
+
+    /**
+     * @brief Enumeration of encoder position handling on range change.
+     */
+    typedef enum
+    {
+        ZH_ENCODER_REINIT_RESET, /*!< Position is set to (encoder_min_value + encoder_max_value)/2. */
+        ZH_ENCODER_REINIT_REMAP, /*!< Position is moved proportionally to the new range and aligned to the new step. */
+        ZH_ENCODER_REINIT_CLAMP  /*!< Position is kept and clamped into the new range. */
+    } zh_encoder_reinit_mode_t;
+
+    /**
+     * @brief Enumeration of encoder index pulse handling.
+     */
+    typedef enum
+    {
+        ZH_ENCODER_INDEX_LATCH, /*!< Position error is measured at every index pulse. The position is set to index_position only by homing. */
+        ZH_ENCODER_INDEX_RESET  /*!< Position is set to index_position at every index pulse. */
+    } zh_encoder_index_mode_t;
+
+    /**
+     * @brief Structure for encoder profile (range, step and value mapping curve).
+     *
+     * @note Must be initialized with zh_encoder_profile_init. The value mapping curve is precomputed, so switching profiles does not recalculate it.
+     */
+    typedef struct
+    {
+        float encoder_min_value;                                                 /*!< Encoder min value. */
+        float encoder_max_value;                                                 /*!< Encoder max value. */
+        float encoder_step;                                                      /*!< Encoder step. */
+        zh_encoder_mapping_t mapping;                                            /*!< Value mapping curve. */
+        float mapping_lut[ZH_ENCODER_MAPPING_LUT_SIZE];                          /*!< Precomputed log or exp curve. @note Uniformly spaced between min and max position. */
+        zh_encoder_mapping_point_t mapping_table[ZH_ENCODER_MAPPING_TABLE_SIZE]; /*!< Value mapping table. */
+        uint8_t mapping_table_size;                                              /*!< Number of value mapping table breakpoints. */
+    } zh_encoder_profile_t;
+
+    /**
+     * @brief Structure for encoder acceleration table entry.
+     */
+    typedef struct
+    {
+        uint16_t step_rate;  /*!< Step rate threshold. @note In steps per second. */
+        uint16_t multiplier; /*!< Step multiplier applied when step rate reaches the threshold. @note 0 means end of table. */
+    } zh_encoder_acceleration_t;
+
+    /**
+     * @brief Encoder position change callback.
+     *
+     * @param[in] encoder_number Encoder unique number.
+     * @param[in] position Encoder new position.
+     * @param[in] delta Encoder position change.
+     * @param[in] arg User context pointer.
+     */
+    typedef void (*zh_encoder_callback_t)(uint8_t encoder_number, float position, float delta, void *arg);
+
+    /**
+     * @brief Encoder position change isr callback.
+     *
+     * @note Called from isr without floating point arguments.
+     *
+     * @param[in] encoder_number Encoder unique number.
+     * @param[in] ticks Encoder new position in steps.
+     * @param[in] delta Encoder position change in steps.
+     * @param[in] arg User context pointer.
+     */
+    typedef void (*zh_encoder_isr_callback_t)(uint8_t encoder_number, int64_t ticks, int32_t delta, void *arg);
+
+    /**
+     * @brief Structure for encoder runtime metrics storage.
+     *
+     * @note Latency histogram bucket N counts latencies from 2^N to 2^(N+1) microseconds. The last bucket also counts all longer latencies.
+     */
+    typedef struct
+    {
+        uint32_t step_count;                                  /*!< Number of steps counted in isr. */
+        uint32_t step_drop_count;                             /*!< Number of steps dropped in isr. */
+        uint32_t event_post_count;                            /*!< Number of events posted. */
+        uint32_t event_post_error;                            /*!< Number of event post error. */
+        uint32_t event_skip_count;                            /*!< Number of position changes merged into a later event or skipped by the minimum event interval. */
+        uint32_t step_reject_count;                           /*!< Number of transitions rejected by hysteresis. @note A rejected reversal and the step that cancels it are counted as two transitions. */
+        uint32_t persistence_write_count;                     /*!< Number of position writes to NVS. */
+        uint32_t persistence_write_avoided;                   /*!< Number of position changes not written to NVS due to the quiet period or unchanged value. */
+        uint32_t pending_steps_max;                           /*!< Maximum number of steps accumulated before processing. */
+        uint32_t process_latency[ZH_ENCODER_LATENCY_BUCKETS]; /*!< Histogram of latency from isr to processing. */
+        uint32_t post_latency[ZH_ENCODER_LATENCY_BUCKETS];    /*!< Histogram of latency from processing to event post completion. */
+    } zh_encoder_metrics_t;
 
     /**
      * @brief Structure for initial initialization of encoder.
      */
     typedef struct
     {
-        float encoder_step;            /*!< Encoder step. @note Must be greater than 0. */
-        float encoder_min_value;       /*!< Encoder min value. @note Must be less than encoder_max_value. */
-        float encoder_max_value;       /*!< Encoder max value. @note Must be greater than encoder_min_value. */
-        uint8_t task_priority;         /*!< Task priority for the encoder isr processing. @note Minimum value is 1. */
-        uint8_t queue_size;            /*!< Queue size for task for the encoder processing. @note Minimum value is 1. */
-        uint8_t a_gpio_number;         /*!< Encoder A GPIO number. */
-        uint8_t b_gpio_number;         /*!< Encoder B GPIO number. */
-        uint8_t s_gpio_number;         /*!< Encoder button GPIO number. */
-        bool pullup;                   /*!< Pullup GPIO enable/disable. */
-        uint16_t s_gpio_debounce_time; /*!< Encoder button debounce_time. @note In microseconds. */
-        uint8_t encoder_number;        /*!< Unique encoder number. @note Must be greater than 0. */
-        uint16_t stack_size;           /*!< Stack size for task for the encoder isr processing processing. @note The minimum size is configMINIMAL_STACK_SIZE. */
+        float encoder_step;                                                         /*!< Encoder step. @note Must be greater than 0. */
+        float encoder_min_value;                                                    /*!< Encoder min value. @note Must be less than encoder_max_value. */
+        float encoder_max_value;                                                    /*!< Encoder max value. @note Must be greater than encoder_min_value. */
+        uint8_t task_priority;                                                      /*!< Task priority for the encoder isr processing. @note Minimum value is 1. */
+        uint8_t queue_size;                                                         /*!< Queue size for task for the encoder processing. @note Minimum value is 1. Not used, steps are accumulated per encoder. */
+        uint8_t a_gpio_number;                                                      /*!< Encoder A GPIO number. */
+        uint8_t b_gpio_number;                                                      /*!< Encoder B GPIO number. */
+        uint8_t s_gpio_number;                                                      /*!< Encoder button GPIO number. */
+        bool pullup;                                                                /*!< Pullup GPIO enable/disable. */
+        uint16_t s_gpio_debounce_time;                                              /*!< Encoder button debounce_time. @note In microseconds. */
+        uint8_t encoder_number;                                                     /*!< Unique encoder number. @note Must be greater than 0. */
+        uint16_t stack_size;                                                        /*!< Stack size for task for the encoder isr processing processing. @note The minimum size is configMINIMAL_STACK_SIZE. */
+        bool counter_mode;                                                          /*!< High-speed counter mode enable/disable. @note PCNT counts freely, no interrupt per step. */
+        int16_t counter_high_limit;                                                 /*!< PCNT high limit in counter mode. @note Must be greater than 0. */
+        int16_t counter_low_limit;                                                  /*!< PCNT low limit in counter mode. @note Must be less than 0. */
+        uint16_t counter_event_period;                                              /*!< Event posting period in counter mode. @note In milliseconds. Must be greater than 0. */
+        bool batch_mode;                                                            /*!< Batch event publishing enable/disable. @note Position changes are posted with ZH_ENCODER_BATCH_EVENT. */
+        uint16_t batch_frame_period;                                                /*!< Batch event frame period. @note In milliseconds. Must be the same for all encoders in batch mode. */
+        zh_encoder_acceleration_t acceleration[ZH_ENCODER_ACCELERATION_TABLE_SIZE]; /*!< Acceleration table. @note Step rate thresholds in ascending order. Empty table disables acceleration. */
+        uint16_t event_timeout;                                                     /*!< Event post timeout. @note In milliseconds. 0 means non-blocking post. */
+        uint16_t event_min_interval;                                                /*!< Minimum interval between position events. @note In milliseconds. 0 means no limit. Not used in batch mode. */
+        zh_encoder_callback_t callback;                                             /*!< Position change callback. @note NULL means disabled. Called from the processing task in addition to ZH_ENCODER_EVENT. */
+        void *callback_arg;                                                         /*!< User context pointer passed to the callbacks. */
+        zh_encoder_isr_callback_t isr_callback;                                     /*!< Position change isr callback. @note NULL means disabled. Must be placed in IRAM and must not block. Not supported in counter mode. */
+        zh_encoder_backend_t backend;                                               /*!< Encoder decoder backend. */
+        zh_encoder_resolution_t resolution;                                         /*!< Encoder counting resolution. */
+        uint8_t counts_per_step;                                                    /*!< Number of counts per one encoder step. @note Must be greater than 0. Use the number of counts per detent for detent-aligned steps. */
+        int8_t task_core;                                                           /*!< Core for the encoder isr processing task. @note -1 means no affinity. */
+        bool button_gestures;                                                       /*!< Button gesture recognition enable/disable. @note Gestures are posted with ZH_BUTTON_GESTURE_EVENT. */
+        bool button_active_low;                                                     /*!< Button is pressed at low level. */
+        uint16_t button_long_press_time;                                            /*!< Button long press time. @note In milliseconds. Must be greater than 0 if gestures are enabled. */
+        uint16_t button_double_click_time;                                          /*!< Maximum interval between clicks of a double click. @note In milliseconds. 0 disables double click, click is posted on release. */
+        uint16_t button_repeat_period;                                              /*!< Button auto-repeat period after long press. @note In milliseconds. 0 disables auto-repeat. */
+        uint16_t glitch_filter_ns;                                                  /*!< PCNT glitch filter width. @note In nanoseconds. 0 disables the filter. Not used by software backend. */
+        uint8_t hysteresis_count;                                                   /*!< Number of consecutive reversed steps required to accept a direction reversal. @note 0 or 1 disables the count threshold. Not used in counter mode. */
+        uint16_t hysteresis_window;                                                 /*!< Direction reversal suppression window after the last accepted step. @note In milliseconds. 0 disables the window. Not used in counter mode. */
+        bool persistence;                                                           /*!< Position persistence in NVS enable/disable. @note Keyed by encoder_number. NVS must be initialized before encoder initialization. */
+        uint16_t persistence_quiet_period;                                          /*!< Time the position must be stable before it is written to NVS. @note In milliseconds. */
+        uint8_t task_group;                                                         /*!< Processing task group. @note Each group has its own processing task. Must be less than ZH_ENCODER_MAX_TASK_GROUPS. Task settings must be the same for all encoders in the group. */
+        bool event_coalescing;                                                      /*!< Last-value-wins event coalescing enable/disable. @note Throttled or failed events are retried later with the newest position instead of being dropped. Not used in batch mode. */
+        uint16_t velocity_window;                                                   /*!< Velocity measurement window. @note In milliseconds. Steps slower than the window are measured by period. 0 means velocity is measured on every step. */
+        float velocity_alpha;                                                       /*!< Alpha gain of the alpha-beta velocity filter. @note From 0 to 1. 0 disables the filter. */
+        float velocity_beta;                                                        /*!< Beta gain of the alpha-beta velocity filter. @note From 0 to 1. Not used if velocity_alpha is 0. */
+        bool wrap_around;                                                           /*!< Endless rotary mode enable/disable. @note Position wraps from max value to min value and back instead of clamping. */
+        zh_encoder_mapping_t mapping;                                               /*!< Value mapping curve. */
+        float mapping_min_value;                                                    /*!< Value at encoder_min_value for log and exp curves. */
+        float mapping_max_value;                                                    /*!< Value at encoder_max_value for log and exp curves. */
+        float mapping_curvature;                                                    /*!< Curvature of log and exp curves. @note Must be greater than 0. Use ln(mapping_max_value / mapping_min_value) for a constant ratio per step. */
+        zh_encoder_mapping_point_t mapping_table[ZH_ENCODER_MAPPING_TABLE_SIZE];    /*!< Value mapping table. @note Positions in ascending order. Values outside of the table are equal to the first or the last value. */
+        uint8_t mapping_table_size;                                                 /*!< Number of value mapping table breakpoints. @note From 2 to ZH_ENCODER_MAPPING_TABLE_SIZE for the table curve. */
+        StackType_t *task_stack;                                                    /*!< Caller-provided stack buffer for the processing task. @note Must hold stack_size bytes and stay valid until the last encoder of the task group is deinitialized. NULL means dynamic allocation or component buffer in static allocation mode. */
+        StaticTask_t *task_tcb;                                                     /*!< Caller-provided task control block for the processing task. @note Used together with task_stack. */
+        esp_event_loop_handle_t event_loop;                                         /*!< Event loop for encoder events. @note NULL means the default event loop. Must be the same for all encoders in batch mode in the task group. */
+        uint8_t z_gpio_number;                                                      /*!< Encoder index (Z) GPIO number. @note GPIO_NUM_MAX means no index. Not supported with acceleration. */
+        zh_encoder_index_mode_t index_mode;                                         /*!< Index pulse handling. */
+        float index_position;                                                       /*!< Encoder position at the index pulse. @note Must be between encoder_min_value and encoder_max_value. */
+        bool index_active_low;                                                      /*!< Index pulse active level. @note The position is latched on the falling edge if true, on the rising edge otherwise. */
     } zh_encoder_init_config_t;
 
     /**
@@ -61,28 +318,158 @@ extern "C"
      */
     typedef struct
     {
-        bool s_gpio_status;                          /*!< Encoder button status. */
-        bool is_initialized;                         /*!< Encoder initialization flag. */
-        uint8_t encoder_number;                      /*!< Encoder unique number. */
-        uint8_t s_gpio_number;                       /*!< Encoder button GPIO number. */
-        uint16_t s_gpio_debounce_time;               /*!< Encoder button debounce_time. */
-        uint64_t s_gpio_prev_time;                   /*!< Encoder button prev interrupt time. */
-        float encoder_step;                          /*!< Encoder step. */
-        float encoder_position;                      /*!< Encoder position. */
-        float encoder_min_value;                     /*!< Encoder min value. */
-        float encoder_max_value;                     /*!< Encoder max value. */
-        pcnt_unit_handle_t pcnt_unit_handle;         /*!< Encoder unique pcnt unit handle. */
-        pcnt_channel_handle_t pcnt_channel_a_handle; /*!< Encoder unique pcnt channel handle. */
-        pcnt_channel_handle_t pcnt_channel_b_handle; /*!< Encoder unique pcnt channel handle. */
+        bool s_gpio_status;                                                         /*!< Encoder button status. */
+        volatile bool s_gpio_replay_level;                                          /*!< Encoder button level fed by trace replay. */
+        bool is_initialized;                                                        /*!< Encoder initialization flag. */
+        bool counter_mode;                                                          /*!< Encoder high-speed counter mode flag. */
+        uint8_t encoder_number;                                                     /*!< Encoder unique number. */
+        uint8_t s_gpio_number;                                                      /*!< Encoder button GPIO number. */
+        uint16_t s_gpio_debounce_time;                                              /*!< Encoder button debounce_time. */
+        uint64_t s_gpio_prev_time;                                                  /*!< Encoder button prev interrupt time. @note Last edge time processed in task. */
+        float encoder_step;                                                         /*!< Encoder step. */
+        double encoder_origin;                                                      /*!< Encoder position at zero ticks. */
+        int64_t encoder_ticks;                                                      /*!< Encoder position in steps from the origin. */
+        int64_t encoder_min_ticks;                                                  /*!< Encoder min position in steps from the origin. */
+        int64_t encoder_max_ticks;                                                  /*!< Encoder max position in steps from the origin. */
+        int64_t encoder_step_time;                                                  /*!< Encoder last processed step time. @note In microseconds. */
+        int8_t encoder_direction;                                                   /*!< Encoder last processed step direction. */
+        float encoder_min_value;                                                    /*!< Encoder min value. */
+        float encoder_max_value;                                                    /*!< Encoder max value. */
+        pcnt_unit_handle_t pcnt_unit_handle;                                        /*!< Encoder unique pcnt unit handle. */
+        pcnt_channel_handle_t pcnt_channel_a_handle;                                /*!< Encoder unique pcnt channel handle. */
+        pcnt_channel_handle_t pcnt_channel_b_handle;                                /*!< Encoder unique pcnt channel handle. */
+        int pcnt_high_watch_point;                                                  /*!< Encoder pcnt high watch point. */
+        int pcnt_low_watch_point;                                                   /*!< Encoder pcnt low watch point. */
+        int counter_value;                                                          /*!< Encoder last processed pcnt count in counter mode. */
+        esp_timer_handle_t counter_timer_handle;                                    /*!< Encoder unique timer handle in counter mode. */
+        volatile bool counter_update_request;                                       /*!< Encoder counter update request flag in counter mode. */
+        volatile int32_t pending_steps;                                             /*!< Encoder steps accumulated in isr and not yet processed. */
+        bool batch_mode;                                                            /*!< Encoder batch event publishing flag. */
+        int64_t batch_start_ticks;                                                  /*!< Encoder ticks at the beginning of the current batch frame. */
+        uint32_t batch_step_count;                                                  /*!< Encoder steps processed in the current batch frame. */
+        volatile uint32_t step_time;                                                /*!< Encoder last step time. @note In microseconds. */
+        uint32_t acceleration_prev_time;                                            /*!< Encoder last processed step time for acceleration. */
+        int8_t acceleration_direction;                                              /*!< Encoder last processed step direction for acceleration. */
+        zh_encoder_acceleration_t acceleration[ZH_ENCODER_ACCELERATION_TABLE_SIZE]; /*!< Encoder acceleration table. */
+        volatile uint32_t pending_time;                                             /*!< Encoder first not processed step time. @note In microseconds. */
+        volatile uint32_t metrics_sequence;                                         /*!< Encoder metrics update sequence counter. */
+        zh_encoder_metrics_t metrics;                                               /*!< Encoder runtime metrics. */
+        uint16_t event_timeout;                                                     /*!< Encoder event post timeout. */
+        uint16_t event_min_interval;                                                /*!< Encoder minimum interval between position events. */
+        bool event_coalescing;                                                      /*!< Encoder event coalescing flag. */
+        bool event_pending;                                                         /*!< Encoder position event waiting to be posted. */
+        int64_t event_prev_time;                                                    /*!< Encoder last posted event time. @note In microseconds. */
+        zh_encoder_callback_t callback;                                             /*!< Encoder position change callback. */
+        void *callback_arg;                                                         /*!< Encoder callback user context pointer. */
+        zh_encoder_isr_callback_t isr_callback;                                     /*!< Encoder position change isr callback. */
+        bool callback_in_isr;                                                       /*!< Encoder position applied in isr flag. */
+        volatile int32_t isr_ticks_delta;                                           /*!< Encoder ticks applied in isr and not yet processed. */
+        uint8_t encoder_index;                                                      /*!< Encoder slot index in the encoder list. */
+        zh_encoder_backend_t backend;                                               /*!< Encoder decoder backend. */
+        uint8_t a_gpio_number;                                                      /*!< Encoder A GPIO number. */
+        uint8_t b_gpio_number;                                                      /*!< Encoder B GPIO number. */
+        uint8_t software_state;                                                     /*!< Encoder last A/B state for software backend. */
+        int16_t software_transitions;                                               /*!< Encoder valid A/B transitions since the last step for software backend. */
+        int16_t software_step_transitions;                                          /*!< Encoder valid A/B transitions per step for software backend. */
+        uint8_t counts_per_step;                                                    /*!< Encoder number of counts per one step. */
+        uint8_t task_group;                                                         /*!< Encoder processing task group. */
+        TaskHandle_t task_handle;                                                   /*!< Encoder processing task handle. */
+        bool button_gestures;                                                       /*!< Encoder button gesture recognition flag. */
+        bool button_active_low;                                                     /*!< Encoder button active low flag. */
+        uint16_t button_long_press_time;                                            /*!< Encoder button long press time. */
+        uint16_t button_double_click_time;                                          /*!< Encoder button double click time. */
+        uint16_t button_repeat_period;                                              /*!< Encoder button auto-repeat period. */
+        volatile bool button_edge_pending;                                          /*!< Encoder button edge waiting for processing. */
+        volatile uint32_t button_edge_time;                                         /*!< Encoder button last edge time. @note In microseconds. */
+        bool button_debounce_pending;                                               /*!< Encoder button level waiting for debounce time. */
+        uint8_t button_state;                                                       /*!< Encoder button gesture state. */
+        uint16_t button_repeat_count;                                               /*!< Encoder button auto-repeat counter. */
+        int64_t button_deadline;                                                    /*!< Encoder button gesture deadline. @note In microseconds. 0 means no deadline. */
+        uint8_t hysteresis_count;                                                   /*!< Encoder reversed steps required to accept a direction reversal. */
+        uint16_t hysteresis_window;                                                 /*!< Encoder direction reversal suppression window. */
+        int8_t hysteresis_direction;                                                /*!< Encoder last accepted step direction. */
+        uint16_t hysteresis_reversals;                                              /*!< Encoder reversed steps held back by hysteresis. */
+        uint32_t hysteresis_time;                                                   /*!< Encoder last accepted step time. @note In microseconds. */
+        bool persistence;                                                           /*!< Encoder position persistence flag. */
+        uint16_t persistence_quiet_period;                                          /*!< Encoder position persistence quiet period. */
+        volatile bool persistence_request;                                          /*!< Encoder position changed and not yet scheduled for writing. */
+        bool persistence_dirty;                                                     /*!< Encoder position waiting for the quiet period. */
+        bool persistence_stored;                                                    /*!< Encoder stored position value is valid. */
+        uint32_t persistence_value;                                                 /*!< Encoder last stored position value. */
+        int64_t persistence_deadline;                                               /*!< Encoder position write deadline. @note In microseconds. */
+        uint16_t velocity_window;                                                   /*!< Encoder velocity measurement window. */
+        float velocity_alpha;                                                       /*!< Encoder alpha-beta velocity filter alpha gain. */
+        float velocity_beta;                                                        /*!< Encoder alpha-beta velocity filter beta gain. */
+        int8_t velocity_direction;                                                  /*!< Encoder direction of the current velocity measurement window. */
+        uint32_t velocity_window_time;                                              /*!< Encoder current velocity measurement window start time. @note In microseconds. */
+        int32_t velocity_window_steps;                                              /*!< Encoder steps in the current velocity measurement window. */
+        float velocity_offset;                                                      /*!< Encoder alpha-beta filter position estimate relative to the measured position. @note In steps. */
+        volatile float velocity;                                                    /*!< Encoder measured velocity. @note In steps per second. */
+        volatile uint32_t velocity_step_time;                                       /*!< Encoder last step time for velocity. @note In microseconds. */
+        bool wrap_around;                                                           /*!< Encoder endless rotary mode flag. */
+        zh_encoder_profile_t profile;                                               /*!< Encoder profile from the initial configuration. */
+        const zh_encoder_profile_t *mapping_profile;                                /*!< Encoder active profile for value mapping. */
+        esp_event_loop_handle_t event_loop;                                         /*!< Encoder event loop. @note NULL means the default event loop. */
+        uint8_t z_gpio_number;                                                      /*!< Encoder index GPIO number. */
+        zh_encoder_index_mode_t index_mode;                                         /*!< Encoder index pulse handling. */
+        float index_position;                                                       /*!< Encoder position at the index pulse. */
+        volatile bool index_pending;                                                /*!< Encoder index pulse waiting for processing. */
+        bool index_homing;                                                          /*!< Encoder homing armed. @note The position is set to index_position at the next index pulse. */
+        bool index_homed;                                                           /*!< Encoder position is referenced to the index pulse. */
+        bool index_corrected;                                                       /*!< Encoder position was set to index_position at the last index pulse. */
+        int64_t index_latch;                                                        /*!< Encoder state latched at the index pulse. @note Pcnt count in counter mode, ticks with callback in isr, isr step total otherwise. */
+        uint32_t index_latch_sequence;                                              /*!< Encoder origin sequence at the index pulse. */
+        volatile uint32_t index_count;                                              /*!< Encoder number of index pulses. */
+        float index_encoder_position;                                               /*!< Encoder position at the last processed index pulse. */
+        float index_error;                                                          /*!< Encoder position error at the last processed index pulse. */
+        volatile int32_t index_step_total;                                          /*!< Encoder steps accumulated in isr. @note Wraps around. */
+        int32_t index_step_applied;                                                 /*!< Encoder steps taken by the processing task. @note Wraps around. */
+        uint32_t origin_sequence;                                                   /*!< Encoder origin change sequence counter. */
     } zh_encoder_handle_t;
 
+    /**
+     * @brief Structure for encoder state snapshot.
+     */
+    typedef struct
+    {
+        float encoder_position; /*!< Encoder position. */
+        float encoder_value;    /*!< Encoder mapped value. */
+        int64_t encoder_ticks;  /*!< Encoder position in steps from the last set position. */
+        int64_t step_time;      /*!< Encoder last step time. @note In microseconds since boot. 0 if there were no steps. */
+        int8_t direction;       /*!< Encoder last step direction. @note 1 - clockwise, -1 - counterclockwise, 0 - no steps. */
+        uint8_t encoder_number; /*!< Encoder unique number. */
+        bool button_status;     /*!< Encoder button status. @note Debounced level, 1 - high, 0 - low. */
+    } zh_encoder_snapshot_t;
+
+    /**
+     * @brief Enumeration of encoder trace record types.
+     */
+    typedef enum
+    {
+        ZH_ENCODER_TRACE_STEP,   /*!< Step from isr. @note Value is the number of steps with direction sign. */
+        ZH_ENCODER_TRACE_BUTTON, /*!< Button edge from isr. @note Value is the button GPIO level after the edge. */
+        ZH_ENCODER_TRACE_DROP,   /*!< Steps dropped in isr. @note Value is the number of dropped steps. */
+        ZH_ENCODER_TRACE_INDEX   /*!< Index pulse from isr. */
+    } zh_encoder_trace_type_t;
+
+    /**
+     * @brief Structure for encoder trace record.
+     */
+    typedef struct
+    {
+        uint32_t time;          /*!< Record time. @note In microseconds since boot, truncated to 32 bits. */
+        uint8_t encoder_number; /*!< Encoder unique number. */
+        uint8_t type;           /*!< Record type. @note One of zh_encoder_trace_type_t. */
+        int16_t value;          /*!< Record value. */
+    } zh_encoder_trace_record_t;
+
     /**
      * @brief Structure for error statistics storage.
      */
     typedef struct
     {
         uint32_t event_post_error;     /*!< Number of event post error. */
-        uint32_t queue_overflow_error; /*!< Number of queue overflow error. */
+        uint32_t queue_overflow_error; /*!< Number of queue overflow error. @note Not used, steps are never dropped. */
         uint32_t min_stack_size;       /*!< Minimum free stack size. */
     } zh_encoder_stats_t;
 
@@ -91,10 +478,24 @@ extern "C"
      */
     typedef enum
     {
-        ZH_BUTTON_EVENT, /*!< Button event. */
-        ZH_ENCODER_EVENT /*!< Encoder event. */
+        ZH_BUTTON_EVENT,         /*!< Button event. */
+        ZH_ENCODER_EVENT,        /*!< Encoder event. */
+        ZH_ENCODER_BATCH_EVENT,  /*!< Encoder batch event. */
+        ZH_BUTTON_GESTURE_EVENT, /*!< Button gesture event. */
+        ZH_INDEX_EVENT           /*!< Index pulse event. */
     } zh_encoder_event_id_t;
 
+    /**
+     * @brief Enumeration of encoder button gestures.
+     */
+    typedef enum
+    {
+        ZH_ENCODER_GESTURE_CLICK,        /*!< Short press and release. */
+        ZH_ENCODER_GESTURE_DOUBLE_CLICK, /*!< Two clicks within double click time. */
+        ZH_ENCODER_GESTURE_LONG_PRESS,   /*!< Press held for long press time. */
+        ZH_ENCODER_GESTURE_REPEAT        /*!< Auto-repeat while held after long press. */
+    } zh_encoder_button_gesture_t;
+
     ESP_EVENT_DECLARE_BASE(ZH_ENCODER);
 
     /**
@@ -105,9 +506,35 @@ extern "C"
     typedef struct
     {
         float encoder_position; /*!< Encoder current position. */
+        float encoder_value;    /*!< Encoder current mapped value. */
+        float encoder_velocity; /*!< Encoder current velocity. @note In position units per second. */
         uint8_t encoder_number; /*!< Encoder unique number. */
     } zh_encoder_event_on_isr_t;
 
+    /**
+     * @brief Structure for one encoder data in batch event.
+     */
+    typedef struct
+    {
+        float encoder_position; /*!< Encoder current position. */
+        float encoder_value;    /*!< Encoder current mapped value. */
+        float encoder_delta;    /*!< Encoder position change during the frame. */
+        float encoder_velocity; /*!< Encoder current velocity. @note In position units per second. */
+        uint32_t step_count;    /*!< Number of steps processed during the frame. */
+        uint8_t encoder_number; /*!< Encoder unique number. */
+    } zh_encoder_batch_item_t;
+
+    /**
+     * @brief Structure for sending data to the event handler when batch frame is completed.
+     *
+     * @note Should be used with ZH_ENCODER event base and ZH_ENCODER_BATCH_EVENT event ID.
+     */
+    typedef struct
+    {
+        uint8_t encoder_quantity;                                      /*!< Number of changed encoders in the frame. */
+        zh_encoder_batch_item_t encoder_data[ZH_ENCODER_MAX_QUANTITY]; /*!< Changed encoders data. */
+    } zh_encoder_batch_event_on_isr_t;
+
     /**
      * @brief Structure for sending data to the event handler when cause encoder button interrupt.
      *
@@ -119,11 +546,46 @@ extern "C"
         bool button_status;     /*!< Encoder button status. */
     } zh_encoder_button_event_on_isr_t;
 
+    /**
+     * @brief Structure for sending data to the event handler when button gesture is recognized.
+     *
+     * @note Should be used with ZH_ENCODER event base and ZH_BUTTON_GESTURE_EVENT event ID.
+     */
+    typedef struct
+    {
+        uint8_t encoder_number;              /*!< Encoder unique number. */
+        zh_encoder_button_gesture_t gesture; /*!< Recognized gesture. */
+        uint16_t repeat_count;               /*!< Auto-repeat counter. @note Starts from 1 for the first ZH_ENCODER_GESTURE_REPEAT. */
+    } zh_encoder_button_gesture_event_t;
+
+    /**
+     * @brief Structure for sending data to the event handler when index pulse is processed.
+     *
+     * @note Should be used with ZH_ENCODER event base and ZH_INDEX_EVENT event ID.
+     */
+    typedef struct
+    {
+        float encoder_position; /*!< Encoder position at the index pulse. @note Before correction. */
+        float position_error;   /*!< Position error at the index pulse. @note Position at the pulse minus index_position. Nearest turn in wrap-around mode. */
+        uint32_t index_count;   /*!< Number of index pulses since initialization. */
+        uint8_t encoder_number; /*!< Encoder unique number. */
+        bool is_homed;          /*!< Encoder position is referenced to the index pulse. @note Set by homing or by ZH_ENCODER_INDEX_RESET. */
+        bool is_corrected;      /*!< Encoder position was set to index_position at this pulse. */
+    } zh_encoder_index_event_t;
+
     /**
      * @brief Initialize encoder.
      *
      * @note The encoder will be set to the position (encoder_min_value + encoder_max_value)/2.
      *
+     * @note With CONFIG_ZH_ENCODER_STATIC_ALLOCATION the processing task is created with static buffers only. The PCNT driver, GPIO isr service,
+     * esp_timer and esp_event still allocate their own resources at initialization.
+     *
+     * @note With persistence enabled, the position stored in NVS is restored if it is within min/max values.
+     *
+     * @note In counter mode the PCNT counts freely between counter_low_limit and counter_high_limit with overflow accumulation,
+     * the position is calculated from the hardware count and events are posted not more often than counter_event_period.
+     *
      * @param[in] config Pointer to encoder initialized configuration structure. Can point to a temporary variable.
      * @param[out] handle Pointer to unique encoder handle.
      *
@@ -135,9 +597,25 @@ extern "C"
      */
     esp_err_t zh_encoder_init(const zh_encoder_init_config_t *config, zh_encoder_handle_t *handle);
 
+    /**
+     * @brief Initialize a set of encoders.
+     *
+     * @note The whole set is validated before any encoder is initialized and shared resources are allocated once.
+     * If any encoder fails, the already initialized encoders of the set are deinitialized.
+     *
+     * @param[in] configs Pointer to the array of encoder initialized configuration structures.
+     * @param[out] handles Pointer to the array of unique encoder handles.
+     * @param[in] quantity Number of encoders.
+     *
+     * @return ESP_OK if success or an error code otherwise.
+     */
+    esp_err_t zh_encoder_init_many(const zh_encoder_init_config_t *configs, zh_encoder_handle_t *handles, uint8_t quantity);
+
     /**
      * @brief Deinitialize encoder.
      *
+     * @note Waits for the processing task of the task group to finish its current pass, so the handle memory can be released after return.
+     *
      * @param[in, out] handle Pointer to unique encoder handle.
      *
      * @return ESP_OK if success or an error code otherwise.
@@ -158,6 +636,46 @@ extern "C"
      */
     esp_err_t zh_encoder_reinit(zh_encoder_handle_t *handle, float min, float max, float step);
 
+    /**
+     * @brief Reinitialize encoder (change min, max and step values) keeping the position.
+     *
+     * @note Range and position are changed atomically, no intermediate position is observable.
+     *
+     * @param[in, out] handle Pointer to unique encoder handle.
+     * @param[in] min Encoder min value. @note Must be less than encoder_max_value.
+     * @param[in] max Encoder max value. @note Must be greater than encoder_min_value.
+     * @param[in] step Encoder step. @note Must be greater than 0.
+     * @param[in] mode Position handling.
+     *
+     * @return ESP_OK if success or an error code otherwise.
+     */
+    esp_err_t zh_encoder_reinit_mode(zh_encoder_handle_t *handle, float min, float max, float step, zh_encoder_reinit_mode_t mode);
+
+    /**
+     * @brief Initialize encoder profile.
+     *
+     * @note Range, step and value mapping settings are taken from the configuration, other settings are ignored.
+     *
+     * @param[in] config Pointer to encoder initialized configuration structure.
+     * @param[out] profile Pointer to the profile.
+     *
+     * @return ESP_OK if success or an error code otherwise.
+     */
+    esp_err_t zh_encoder_profile_init(const zh_encoder_init_config_t *config, zh_encoder_profile_t *profile);
+
+    /**
+     * @brief Switch encoder profile.
+     *
+     * @note Range, step and value mapping curve are switched atomically in constant time. The profile must stay valid while it is active.
+     *
+     * @param[in, out] handle Pointer to unique encoder handle.
+     * @param[in] profile Pointer to the profile. @note NULL means the profile from the initial configuration.
+     * @param[in] mode Position handling.
+     *
+     * @return ESP_OK if success or an error code otherwise.
+     */
+    esp_err_t zh_encoder_set_profile(zh_encoder_handle_t *handle, const zh_encoder_profile_t *profile, zh_encoder_reinit_mode_t mode);
+
     /**
      * @brief Set encoder position.
      *
@@ -178,6 +696,119 @@ extern "C"
      */
     esp_err_t zh_encoder_get(const zh_encoder_handle_t *handle, float *position);
 
+    /**
+     * @brief Get encoder mapped value.
+     *
+     * @note The value is calculated from the position with the precomputed mapping curve. Equal to the position for the linear curve.
+     *
+     * @param[in] handle Pointer to unique encoder handle.
+     * @param[out] value Encoder mapped value.
+     *
+     * @return ESP_OK if success or an error code otherwise.
+     */
+    esp_err_t zh_encoder_get_value(const zh_encoder_handle_t *handle, float *value);
+
+    /**
+     * @brief Get encoder position in raw steps.
+     *
+     * @note The position is equal to the last set position (or (encoder_min_value + encoder_max_value)/2) plus ticks multiplied by encoder_step.
+     *
+     * @param[in] handle Pointer to unique encoder handle.
+     * @param[out] ticks Encoder position in steps from the last set position.
+     *
+     * @return ESP_OK if success or an error code otherwise.
+     */
+    esp_err_t zh_encoder_get_ticks(const zh_encoder_handle_t *handle, int64_t *ticks);
+
+    /**
+     * @brief Get encoder state snapshot.
+     *
+     * @note Lock-free and log-free. Position, ticks, last step time and direction are read as one consistent state.
+     *
+     * @param[in] handle Pointer to unique encoder handle.
+     * @param[out] snapshot Pointer to the snapshot structure.
+     *
+     * @return ESP_OK if success or an error code otherwise.
+     */
+    esp_err_t zh_encoder_get_snapshot(const zh_encoder_handle_t *handle, zh_encoder_snapshot_t *snapshot);
+
+    /**
+     * @brief Get encoder velocity.
+     *
+     * @note Velocity is measured from step timestamps over velocity_window (period of one step at low speed) without the acceleration multiplier.
+     * It decays to 0 when no steps arrive for longer than the measured step period.
+     *
+     * @param[in] handle Pointer to unique encoder handle.
+     * @param[out] velocity Encoder velocity. @note In position units (encoder_step per step) per second. Positive is clockwise.
+     *
+     * @return ESP_OK if success or an error code otherwise.
+     */
+    esp_err_t zh_encoder_get_velocity(const zh_encoder_handle_t *handle, float *velocity);
+
+    /**
+     * @brief Get state snapshots of all initialized encoders.
+     *
+     * @note Lock-free and log-free. All encoders are sampled at the same instant.
+     *
+     * @param[out] snapshots Pointer to the array of snapshot structures.
+     * @param[in] size Size of the array.
+     * @param[out] quantity Number of filled snapshots.
+     *
+     * @return ESP_OK if success or an error code otherwise.
+     */
+    esp_err_t zh_encoder_get_snapshot_all(zh_encoder_snapshot_t *snapshots, uint8_t size, uint8_t *quantity);
+
+    /**
+     * @brief Read encoder state snapshot without argument checks.
+     *
+     * @note Hot path variant of zh_encoder_get_snapshot. The handle must be initialized and the snapshot pointer must be valid.
+     *
+     * @param[in] handle Pointer to unique encoder handle.
+     * @param[out] snapshot Pointer to the snapshot structure.
+     */
+    void zh_encoder_read(const zh_encoder_handle_t *handle, zh_encoder_snapshot_t *snapshot);
+
+    /**
+     * @brief Wait for position or button change of any encoder of a set.
+     *
+     * @note Blocks the calling task until the processing task reports a change of any selected encoder. The calling task is woken with its
+     * direct-to-task notification (index 0), which must not be used for other purposes by the task. Changes before the call are not reported.
+     *
+     * @param[in] handles Pointer to the array of pointers to unique encoder handles.
+     * @param[in] quantity Number of encoders in the set.
+     * @param[in] timeout Maximum waiting time. @note In ticks. portMAX_DELAY means no timeout.
+     * @param[out] snapshots Pointer to the array of snapshot structures. @note Filled for all encoders of the set, also on timeout.
+     * @param[out] changed Bitmask of changed encoders, bit N for the handle N of the set. @note Can be NULL.
+     *
+     * @return ESP_OK if changed, ESP_ERR_TIMEOUT on timeout or an error code otherwise.
+     */
+    esp_err_t zh_encoder_wait(zh_encoder_handle_t *const *handles, uint8_t quantity, TickType_t timeout, zh_encoder_snapshot_t *snapshots, uint32_t *changed);
+
+    /**
+     * @brief Arm encoder homing.
+     *
+     * @note The position is set to index_position at the next index pulse and ZH_INDEX_EVENT is posted with is_homed set. The correction wakes
+     * zh_encoder_wait, so a task can block until the encoder is homed.
+     *
+     * @param[in, out] handle Pointer to unique encoder handle.
+     *
+     * @return ESP_OK if success or an error code otherwise.
+     */
+    esp_err_t zh_encoder_home(zh_encoder_handle_t *handle);
+
+    /**
+     * @brief Get encoder last index pulse data.
+     *
+     * @note The position at the pulse is calculated from the state latched in the index isr, so the processing latency does not affect the
+     * measured error. An index pulse latched before the position is set or the encoder is reconfigured is ignored.
+     *
+     * @param[in] handle Pointer to unique encoder handle.
+     * @param[out] index Pointer to the index data structure. @note Position and error are 0 before the first processed index pulse.
+     *
+     * @return ESP_OK if success or an error code otherwise.
+     */
+    esp_err_t zh_encoder_get_index(const zh_encoder_handle_t *handle, zh_encoder_index_event_t *index);
+
     /**
      * @brief Reset encoder position.
      *
@@ -189,6 +820,59 @@ extern "C"
      */
     esp_err_t zh_encoder_reset(zh_encoder_handle_t *handle);
 
+    /**
+     * @brief Get encoder runtime metrics.
+     *
+     * @note The metrics are copied as one consistent snapshot.
+     *
+     * @param[in] handle Pointer to unique encoder handle.
+     * @param[out] metrics Pointer to the metrics structure.
+     *
+     * @return ESP_OK if success or an error code otherwise.
+     */
+    esp_err_t zh_encoder_get_metrics(const zh_encoder_handle_t *handle, zh_encoder_metrics_t *metrics);
+
+    /**
+     * @brief Start recording isr activity of all encoders into the trace ring buffer.
+     *
+     * @note The buffer must be placed in internal RAM. The previous buffer is no longer accessed when this function returns and may be freed. The oldest records are overwritten. Counter mode steps are not recorded.
+     *
+     * @param[in] buffer Pointer to the array of trace records.
+     * @param[in] size Size of the array.
+     *
+     * @return ESP_OK if success or an error code otherwise.
+     */
+    esp_err_t zh_encoder_trace_start(zh_encoder_trace_record_t *buffer, uint16_t size);
+
+    /**
+     * @brief Stop recording into the trace ring buffer.
+     */
+    void zh_encoder_trace_freeze(void);
+
+    /**
+     * @brief Export frozen trace records from the oldest to the newest.
+     *
+     * @param[out] records Pointer to the array of trace records.
+     * @param[in] size Size of the array. @note If the array is smaller than the trace, the newest records are exported.
+     * @param[out] quantity Number of exported records.
+     *
+     * @return ESP_OK if success or an error code otherwise.
+     */
+    esp_err_t zh_encoder_trace_export(zh_encoder_trace_record_t *records, uint16_t size, uint16_t *quantity);
+
+    /**
+     * @brief Replay trace records through the encoder processing.
+     *
+     * @note Records are fed to the initialized encoders with the same numbers and ZH_ENCODER_BACKEND_REPLAY backend, keeping the recorded intervals. Records of other encoders are skipped,
+     * so replay never races a live decoder isr. Must not be called from several tasks at the same time. Blocks until the last record is fed.
+     *
+     * @param[in] records Pointer to the array of trace records.
+     * @param[in] quantity Number of records.
+     *
+     * @return ESP_OK if success or an error code otherwise.
+     */
+    esp_err_t zh_encoder_trace_replay(const zh_encoder_trace_record_t *records, uint16_t quantity);
+
     /**
      * @brief Get error statistics.
      *
@@ -0,0 +1,310 @@
+/**
+ * @file zh_encoder.hpp
+ */
+
+#pragma once
+
+#include "zh_encoder.h"
+
+namespace zh
+{
+    /**
+     * @brief Compile-time encoder configuration.
+     *
+     * @note Used as a template parameter of zh::Encoder. Invalid settings fail at compile time.
+     */
+    struct EncoderConfig
+    {
+        gpio_num_t a_gpio_number = GPIO_NUM_MAX; /*!< Encoder A GPIO number. */
+        gpio_num_t b_gpio_number = GPIO_NUM_MAX; /*!< Encoder B GPIO number. */
+        gpio_num_t s_gpio_number = GPIO_NUM_MAX; /*!< Encoder button GPIO number. @note GPIO_NUM_MAX means no button. */
+        gpio_num_t z_gpio_number = GPIO_NUM_MAX; /*!< Encoder index GPIO number. @note GPIO_NUM_MAX means no index. */
+        float encoder_min_value = -10;           /*!< Encoder min value. @note Must be less than encoder_max_value. */
+        float encoder_max_value = 10;            /*!< Encoder max value. @note Must be greater than encoder_min_value. */
+        float encoder_step = 1;                  /*!< Encoder step. @note Must be greater than 0 and not greater than the min/max range. */
+        uint8_t encoder_number = 0;              /*!< Unique encoder number. @note Must be greater than 0. */
+
+        /**
+         * @brief Check the configuration.
+         *
+         * @return True if the configuration is valid.
+         */
+        constexpr bool is_valid() const
+        {
+            return is_gpio_valid() && encoder_max_value > encoder_min_value && encoder_step > 0 && encoder_step <= encoder_max_value - encoder_min_value && encoder_number > 0;
+        }
+
+        /**
+         * @brief Check the GPIO numbers.
+         *
+         * @return True if A and B GPIO are valid and all GPIO numbers are different.
+         */
+        constexpr bool is_gpio_valid() const
+        {
+            return a_gpio_number >= 0 && a_gpio_number < GPIO_NUM_MAX && b_gpio_number >= 0 && b_gpio_number < GPIO_NUM_MAX && a_gpio_number != b_gpio_number &&
+                   (s_gpio_number == GPIO_NUM_MAX || (s_gpio_number >= 0 && s_gpio_number != a_gpio_number && s_gpio_number != b_gpio_number)) &&
+                   (z_gpio_number == GPIO_NUM_MAX || (z_gpio_number >= 0 && z_gpio_number != a_gpio_number && z_gpio_number != b_gpio_number && z_gpio_number != s_gpio_number));
+        }
+    };
+
+    /**
+     * @brief RAII encoder.
+     *
+     * @note The encoder is initialized in the constructor and deinitialized in the destructor. The object can not be copied or moved,
+     * because the component keeps a pointer to its handle.
+     *
+     * @code
+     * zh::Encoder<zh::EncoderConfig{.a_gpio_number = GPIO_NUM_4, .b_gpio_number = GPIO_NUM_16, .encoder_number = 1}> encoder;
+     * @endcode
+     */
+    template <EncoderConfig Config>
+    class Encoder
+    {
+        static_assert(Config.is_gpio_valid(), "Invalid encoder GPIO numbers.");
+        static_assert(Config.is_valid(), "Invalid encoder min/max/step values or encoder number.");
+
+    public:
+        /**
+         * @brief Initialize encoder.
+         *
+         * @param[in] config Initial configuration for the runtime settings. @note Compile-time settings override the same fields.
+         */
+        explicit Encoder(zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT())
+        {
+            config.a_gpio_number = Config.a_gpio_number;
+            config.b_gpio_number = Config.b_gpio_number;
+            config.s_gpio_number = Config.s_gpio_number;
+            config.z_gpio_number = Config.z_gpio_number;
+            config.encoder_min_value = Config.encoder_min_value;
+            config.encoder_max_value = Config.encoder_max_value;
+            config.encoder_step = Config.encoder_step;
+            config.encoder_number = Config.encoder_number;
+            _status = zh_encoder_init(&config, &_handle);
+        }
+
+        /**
+         * @brief Deinitialize encoder.
+         */
+        ~Encoder()
+        {
+            if (_status == ESP_OK)
+            {
+                zh_encoder_deinit(&_handle);
+            }
+        }
+
+        Encoder(const Encoder &) = delete;
+        Encoder &operator=(const Encoder &) = delete;
+
+        /**
+         * @brief Get initialization result.
+         *
+         * @return ESP_OK if the encoder is initialized or an error code otherwise.
+         */
+        esp_err_t status() const { return _status; }
+
+        /**
+         * @brief Check initialization result.
+         */
+        explicit operator bool() const { return _status == ESP_OK; }
+
+        /**
+         * @brief Get encoder position without checks.
+         *
+         * @note The encoder must be initialized. Reads a full snapshot with snapshot().
+         */
+        float position() const { return snapshot().encoder_position; }
+
+        /**
+         * @brief Get encoder mapped value without checks.
+         *
+         * @note The encoder must be initialized. Reads a full snapshot with snapshot().
+         */
+        float value() const { return snapshot().encoder_value; }
+
+        /**
+         * @brief Get encoder position in raw steps without checks.
+         *
+         * @note The encoder must be initialized. Reads a full snapshot with snapshot().
+         */
+        int64_t ticks() const { return snapshot().encoder_ticks; }
+
+        /**
+         * @brief Get encoder state snapshot without checks.
+         *
+         * @note The encoder must be initialized. Not inlined: one lock-free zh_encoder_read call without argument checks and logging.
+         */
+        zh_encoder_snapshot_t snapshot() const
+        {
+            zh_encoder_snapshot_t snapshot;
+            zh_encoder_read(&_handle, &snapshot);
+            return snapshot;
+        }
+
+        /**
+         * @brief Get encoder velocity.
+         *
+         * @param[out] velocity Encoder velocity. @note In position units per second.
+         *
+         * @return ESP_OK if success or an error code otherwise.
+         */
+        esp_err_t velocity(float &velocity) const { return zh_encoder_get_velocity(&_handle, &velocity); }
+
+        /**
+         * @brief Set encoder position.
+         *
+         * @param[in] position Encoder position (must be between encoder_min_value and encoder_max_value).
+         *
+         * @return ESP_OK if success or an error code otherwise.
+         */
+        esp_err_t set(float position) { return zh_encoder_set(&_handle, position); }
+
+        /**
+         * @brief Reset encoder position.
+         *
+         * @return ESP_OK if success or an error code otherwise.
+         */
+        esp_err_t reset() { return zh_encoder_reset(&_handle); }
+
+        /**
+         * @brief Arm homing at the next index pulse.
+         *
+         * @return ESP_OK if success or an error code otherwise.
+         */
+        esp_err_t home() { return zh_encoder_home(&_handle); }
+
+        /**
+         * @brief Get encoder runtime metrics.
+         *
+         * @param[out] metrics Encoder runtime metrics.
+         *
+         * @return ESP_OK if success or an error code otherwise.
+         */
+        esp_err_t metrics(zh_encoder_metrics_t &metrics) const { return zh_encoder_get_metrics(&_handle, &metrics); }
+
+        /**
+         * @brief Get encoder handle for the C API.
+         */
+        zh_encoder_handle_t *handle() { return &_handle; }
+
+        /**
+         * @brief Get encoder number.
+         */
+        static constexpr uint8_t number() { return Config.encoder_number; }
+
+    private:
+        zh_encoder_handle_t _handle = {};
+        esp_err_t _status = ESP_FAIL;
+    };
+
+    /**
+     * @brief Event data type of encoder event ID.
+     */
+    template <zh_encoder_event_id_t Id>
+    struct EventData;
+
+    template <>
+    struct EventData<ZH_BUTTON_EVENT>
+    {
+        using type = zh_encoder_button_event_on_isr_t;
+    };
+
+    template <>
+    struct EventData<ZH_ENCODER_EVENT>
+    {
+        using type = zh_encoder_event_on_isr_t;
+    };
+
+    template <>
+    struct EventData<ZH_ENCODER_BATCH_EVENT>
+    {
+        using type = zh_encoder_batch_event_on_isr_t;
+    };
+
+    template <>
+    struct EventData<ZH_BUTTON_GESTURE_EVENT>
+    {
+        using type = zh_encoder_button_gesture_event_t;
+    };
+
+    template <>
+    struct EventData<ZH_INDEX_EVENT>
+    {
+        using type = zh_encoder_index_event_t;
+    };
+
+    /**
+     * @brief RAII typed subscription to encoder events of one event ID.
+     *
+     * @note The handler is registered in the event loop in the constructor and unregistered in the destructor.
+     * The object can not be copied or moved, because the event loop keeps a pointer to it.
+     *
+     * @code
+     * zh::EventSubscription<ZH_ENCODER_EVENT> subscription([](const zh_encoder_event_on_isr_t &event, void *arg) { printf("%0.3f\n", event.encoder_position); });
+     * @endcode
+     */
+    template <zh_encoder_event_id_t Id>
+    class EventSubscription
+    {
+    public:
+        using Data = typename EventData<Id>::type;
+        using Handler = void (*)(const Data &data, void *arg);
+
+        /**
+         * @brief Register the event handler.
+         *
+         * @param[in] handler Event handler.
+         * @param[in] arg User context pointer passed to the handler.
+         * @param[in] event_loop Event loop. @note nullptr means the default event loop. Must match event_loop of the encoders.
+         */
+        explicit EventSubscription(Handler handler, void *arg = nullptr, esp_event_loop_handle_t event_loop = nullptr) : _handler(handler), _arg(arg), _event_loop(event_loop)
+        {
+            if (_event_loop == nullptr)
+            {
+                _status = esp_event_handler_instance_register(ZH_ENCODER, Id, &_dispatch, this, &_instance);
+            }
+            else
+            {
+                _status = esp_event_handler_instance_register_with(_event_loop, ZH_ENCODER, Id, &_dispatch, this, &_instance);
+            }
+        }
+
+        /**
+         * @brief Unregister the event handler.
+         */
+        ~EventSubscription()
+        {
+            if (_status == ESP_OK && _event_loop == nullptr)
+            {
+                esp_event_handler_instance_unregister(ZH_ENCODER, Id, _instance);
+            }
+            else if (_status == ESP_OK)
+            {
+                esp_event_handler_instance_unregister_with(_event_loop, ZH_ENCODER, Id, _instance);
+            }
+        }
+
+        EventSubscription(const EventSubscription &) = delete;
+        EventSubscription &operator=(const EventSubscription &) = delete;
+
+        /**
+         * @brief Get registration result.
+         *
+         * @return ESP_OK if the handler is registered or an error code otherwise.
+         */
+        esp_err_t status() const { return _status; }
+
+    private:
+        static void _dispatch(void *arg, esp_event_base_t, int32_t, void *event_data)
+        {
+            const EventSubscription *subscription = static_cast<const EventSubscription *>(arg);
+            subscription->_handler(*static_cast<const Data *>(event_data), subscription->_arg);
+        }
+
+        Handler _handler = nullptr;
+        void *_arg = nullptr;
+        esp_event_loop_handle_t _event_loop = nullptr;
+        esp_event_handler_instance_t _instance = nullptr;
+        esp_err_t _status = ESP_FAIL;
+    };
+}
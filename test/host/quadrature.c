@@ -0,0 +1,46 @@
+#include "quadrature.h"
+#include "host.h"
+#include <unistd.h>
+
+static const uint8_t _phase_state[4] = {0, 2, 3, 1};
+
+void quadrature_init(quadrature_t *quadrature, gpio_num_t a_gpio_number, gpio_num_t b_gpio_number)
+{
+    quadrature->a_gpio_number = a_gpio_number;
+    quadrature->b_gpio_number = b_gpio_number;
+    uint8_t state = (gpio_get_level(a_gpio_number) << 1) | gpio_get_level(b_gpio_number);
+    for (uint8_t i = 0; i < 4; ++i)
+    {
+        if (_phase_state[i] == state)
+        {
+            quadrature->phase = i;
+        }
+    }
+}
+
+void quadrature_transition(quadrature_t *quadrature, int direction)
+{
+    quadrature->phase = (quadrature->phase + ((direction > 0) ? 1 : 3)) & 3;
+    uint8_t state = _phase_state[quadrature->phase];
+    host_gpio_set_level(quadrature->a_gpio_number, state >> 1);
+    host_gpio_set_level(quadrature->b_gpio_number, state & 1);
+}
+
+void quadrature_cycles(quadrature_t *quadrature, int cycles)
+{
+    int direction = (cycles > 0) ? 1 : -1;
+    for (int i = 0; i < cycles * direction * 4; ++i)
+    {
+        quadrature_transition(quadrature, direction);
+    }
+}
+
+void quadrature_button(gpio_num_t s_gpio_number, int level, uint8_t bounces, uint32_t bounce_time)
+{
+    for (uint8_t i = 0; i < bounces; ++i)
+    {
+        host_gpio_set_level(s_gpio_number, ((i & 1) != 0) ? !level : level);
+        usleep(bounce_time);
+    }
+    host_gpio_set_level(s_gpio_number, level);
+}
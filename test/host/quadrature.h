@@ -0,0 +1,44 @@
+#pragma once
+
+#include "driver/gpio.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Quadrature waveform generator state.
+ */
+typedef struct
+{
+    gpio_num_t a_gpio_number; /*!< Encoder A GPIO number. */
+    gpio_num_t b_gpio_number; /*!< Encoder B GPIO number. */
+    uint8_t phase;            /*!< Current phase of the A/B cycle. */
+} quadrature_t;
+
+/**
+ * @brief Attach the generator to the A/B pins. The phase is taken from the current pin levels.
+ */
+void quadrature_init(quadrature_t *quadrature, gpio_num_t a_gpio_number, gpio_num_t b_gpio_number);
+
+/**
+ * @brief Drive one A/B transition. Positive direction is A leading B (clockwise).
+ */
+void quadrature_transition(quadrature_t *quadrature, int direction);
+
+/**
+ * @brief Drive full A/B cycles. The sign of cycles is the direction.
+ */
+void quadrature_cycles(quadrature_t *quadrature, int cycles);
+
+/**
+ * @brief Drive a button edge with contact bounce.
+ *
+ * @note The pin toggles bounces times with bounce_time microseconds between toggles before settling at level.
+ */
+void quadrature_button(gpio_num_t s_gpio_number, int level, uint8_t bounces, uint32_t bounce_time);
+
+#ifdef __cplusplus
+}
+#endif
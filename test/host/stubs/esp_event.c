@@ -0,0 +1,188 @@
+#include "esp_event.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define EVENT_HANDLER_MAX 32
+
+typedef struct
+{
+    esp_event_loop_handle_t event_loop;
+    esp_event_base_t event_base;
+    int32_t event_id;
+    esp_event_handler_t event_handler;
+    void *event_handler_arg;
+    bool is_used;
+} event_handler_t;
+
+typedef struct
+{
+    int dummy;
+} event_loop_t;
+
+static pthread_mutex_t _event_mutex = PTHREAD_MUTEX_INITIALIZER;
+static event_handler_t _event_handler[EVENT_HANDLER_MAX] = {0};
+static event_loop_t _default_event_loop = {0};
+static bool _is_default_event_loop_created = false;
+
+static esp_err_t _event_register(esp_event_loop_handle_t event_loop, esp_event_base_t event_base, int32_t event_id, esp_event_handler_t event_handler, void *event_handler_arg,
+                                 esp_event_handler_instance_t *instance)
+{
+    if (event_handler == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&_event_mutex);
+    for (uint8_t i = 0; i < EVENT_HANDLER_MAX; ++i)
+    {
+        if (_event_handler[i].is_used == false)
+        {
+            _event_handler[i] = (event_handler_t){event_loop, event_base, event_id, event_handler, event_handler_arg, true};
+            if (instance != NULL)
+            {
+                *instance = &_event_handler[i];
+            }
+            pthread_mutex_unlock(&_event_mutex);
+            return ESP_OK;
+        }
+    }
+    pthread_mutex_unlock(&_event_mutex);
+    return ESP_ERR_NO_MEM;
+}
+
+static esp_err_t _event_unregister(esp_event_handler_instance_t instance)
+{
+    event_handler_t *handler = instance;
+    if (handler < _event_handler || handler >= _event_handler + EVENT_HANDLER_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&_event_mutex);
+    handler->is_used = false;
+    pthread_mutex_unlock(&_event_mutex);
+    return ESP_OK;
+}
+
+static esp_err_t _event_post(esp_event_loop_handle_t event_loop, esp_event_base_t event_base, int32_t event_id, const void *event_data, size_t event_data_size)
+{
+    event_handler_t handler[EVENT_HANDLER_MAX];
+    uint8_t quantity = 0;
+    pthread_mutex_lock(&_event_mutex);
+    for (uint8_t i = 0; i < EVENT_HANDLER_MAX; ++i)
+    {
+        const event_handler_t *item = &_event_handler[i];
+        if (item->is_used == true && item->event_loop == event_loop && (item->event_base == ESP_EVENT_ANY_BASE || item->event_base == event_base) &&
+            (item->event_id == ESP_EVENT_ANY_ID || item->event_id == event_id))
+        {
+            handler[quantity++] = *item;
+        }
+    }
+    pthread_mutex_unlock(&_event_mutex);
+    void *data = NULL;
+    if (event_data != NULL && event_data_size != 0)
+    {
+        data = malloc(event_data_size);
+        if (data == NULL)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+        memcpy(data, event_data, event_data_size);
+    }
+    for (uint8_t i = 0; i < quantity; ++i)
+    {
+        handler[i].event_handler(handler[i].event_handler_arg, event_base, event_id, data);
+    }
+    free(data);
+    return ESP_OK;
+}
+
+esp_err_t esp_event_loop_create_default(void)
+{
+    pthread_mutex_lock(&_event_mutex);
+    esp_err_t err = (_is_default_event_loop_created == true) ? ESP_ERR_INVALID_STATE : ESP_OK;
+    _is_default_event_loop_created = true;
+    pthread_mutex_unlock(&_event_mutex);
+    return err;
+}
+
+esp_err_t esp_event_loop_delete_default(void)
+{
+    pthread_mutex_lock(&_event_mutex);
+    _is_default_event_loop_created = false;
+    pthread_mutex_unlock(&_event_mutex);
+    return ESP_OK;
+}
+
+esp_err_t esp_event_loop_create(const esp_event_loop_args_t *event_loop_args, esp_event_loop_handle_t *event_loop)
+{
+    if (event_loop_args == NULL || event_loop == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *event_loop = calloc(1, sizeof(event_loop_t));
+    return (*event_loop != NULL) ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_event_loop_delete(esp_event_loop_handle_t event_loop)
+{
+    pthread_mutex_lock(&_event_mutex);
+    for (uint8_t i = 0; i < EVENT_HANDLER_MAX; ++i)
+    {
+        if (_event_handler[i].event_loop == event_loop)
+        {
+            _event_handler[i].is_used = false;
+        }
+    }
+    pthread_mutex_unlock(&_event_mutex);
+    free(event_loop);
+    return ESP_OK;
+}
+
+esp_err_t esp_event_post(esp_event_base_t event_base, int32_t event_id, const void *event_data, size_t event_data_size, TickType_t ticks_to_wait)
+{
+    (void)ticks_to_wait;
+    if (_is_default_event_loop_created == false)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return _event_post(&_default_event_loop, event_base, event_id, event_data, event_data_size);
+}
+
+esp_err_t esp_event_post_to(esp_event_loop_handle_t event_loop, esp_event_base_t event_base, int32_t event_id, const void *event_data, size_t event_data_size, TickType_t ticks_to_wait)
+{
+    (void)ticks_to_wait;
+    if (event_loop == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return _event_post(event_loop, event_base, event_id, event_data, event_data_size);
+}
+
+esp_err_t esp_event_handler_instance_register(esp_event_base_t event_base, int32_t event_id, esp_event_handler_t event_handler, void *event_handler_arg, esp_event_handler_instance_t *instance)
+{
+    return _event_register(&_default_event_loop, event_base, event_id, event_handler, event_handler_arg, instance);
+}
+
+esp_err_t esp_event_handler_instance_register_with(esp_event_loop_handle_t event_loop, esp_event_base_t event_base, int32_t event_id, esp_event_handler_t event_handler, void *event_handler_arg,
+                                                   esp_event_handler_instance_t *instance)
+{
+    if (event_loop == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return _event_register(event_loop, event_base, event_id, event_handler, event_handler_arg, instance);
+}
+
+esp_err_t esp_event_handler_instance_unregister(esp_event_base_t event_base, int32_t event_id, esp_event_handler_instance_t instance)
+{
+    (void)event_base;
+    (void)event_id;
+    return _event_unregister(instance);
+}
+
+esp_err_t esp_event_handler_instance_unregister_with(esp_event_loop_handle_t event_loop, esp_event_base_t event_base, int32_t event_id, esp_event_handler_instance_t instance)
+{
+    (void)event_loop;
+    (void)event_base;
+    (void)event_id;
+    return _event_unregister(instance);
+}
@@ -0,0 +1,214 @@
+#include "esp_timer.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+struct esp_timer
+{
+    esp_timer_cb_t callback;
+    void *arg;
+    bool skip_unhandled_events;
+    bool is_active;
+    int64_t alarm;
+    uint64_t period;
+    struct esp_timer *next;
+};
+
+static pthread_mutex_t _timer_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t _timer_cond;
+static pthread_once_t _timer_once = PTHREAD_ONCE_INIT;
+static pthread_t _timer_thread;
+static struct esp_timer *_timer_list = NULL;
+static struct esp_timer *_timer_running = NULL;
+
+static void *_timer_task(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&_timer_mutex);
+    for (;;)
+    {
+        struct esp_timer *timer = NULL;
+        for (struct esp_timer *item = _timer_list; item != NULL; item = item->next)
+        {
+            if (item->is_active == true && (timer == NULL || item->alarm < timer->alarm))
+            {
+                timer = item;
+            }
+        }
+        if (timer == NULL)
+        {
+            pthread_cond_wait(&_timer_cond, &_timer_mutex);
+            continue;
+        }
+        int64_t now = esp_timer_get_time();
+        if (timer->alarm > now)
+        {
+            struct timespec deadline = {0};
+            clock_gettime(CLOCK_MONOTONIC, &deadline);
+            int64_t wait_ns = (timer->alarm - now) * 1000;
+            deadline.tv_sec += wait_ns / 1000000000;
+            deadline.tv_nsec += wait_ns % 1000000000;
+            if (deadline.tv_nsec >= 1000000000)
+            {
+                ++deadline.tv_sec;
+                deadline.tv_nsec -= 1000000000;
+            }
+            pthread_cond_timedwait(&_timer_cond, &_timer_mutex, &deadline);
+            continue;
+        }
+        if (timer->period == 0)
+        {
+            timer->is_active = false;
+        }
+        else
+        {
+            timer->alarm += timer->period;
+            if (timer->skip_unhandled_events == true && timer->alarm <= now)
+            {
+                timer->alarm = now + timer->period;
+            }
+        }
+        _timer_running = timer;
+        pthread_mutex_unlock(&_timer_mutex);
+        timer->callback(timer->arg);
+        pthread_mutex_lock(&_timer_mutex);
+        _timer_running = NULL;
+        pthread_cond_broadcast(&_timer_cond);
+    }
+    return NULL;
+}
+
+static void _timer_init(void)
+{
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&_timer_cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+    pthread_create(&_timer_thread, NULL, _timer_task, NULL);
+}
+
+static void _timer_wait_idle(esp_timer_handle_t timer)
+{
+    while (_timer_running == timer && pthread_equal(pthread_self(), _timer_thread) == 0)
+    {
+        pthread_cond_wait(&_timer_cond, &_timer_mutex);
+    }
+}
+
+static esp_err_t _timer_start(esp_timer_handle_t timer, uint64_t timeout_us, uint64_t period, bool is_restart)
+{
+    if (timer == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&_timer_mutex);
+    if (timer->is_active != is_restart)
+    {
+        pthread_mutex_unlock(&_timer_mutex);
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->alarm = esp_timer_get_time() + timeout_us;
+    timer->period = period;
+    timer->is_active = true;
+    pthread_cond_broadcast(&_timer_cond);
+    pthread_mutex_unlock(&_timer_mutex);
+    return ESP_OK;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec now = {0};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+    if (create_args == NULL || create_args->callback == NULL || out_handle == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_once(&_timer_once, _timer_init);
+    esp_timer_handle_t timer = calloc(1, sizeof(struct esp_timer));
+    if (timer == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    timer->callback = create_args->callback;
+    timer->arg = create_args->arg;
+    timer->skip_unhandled_events = create_args->skip_unhandled_events;
+    pthread_mutex_lock(&_timer_mutex);
+    timer->next = _timer_list;
+    _timer_list = timer;
+    pthread_mutex_unlock(&_timer_mutex);
+    *out_handle = timer;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    return _timer_start(timer, timeout_us, 0, false);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
+{
+    return _timer_start(timer, period, period, false);
+}
+
+esp_err_t esp_timer_restart(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    if (timer == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return _timer_start(timer, timeout_us, (timer->period != 0) ? timeout_us : 0, true);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (timer == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&_timer_mutex);
+    bool is_active = timer->is_active;
+    timer->is_active = false;
+    _timer_wait_idle(timer);
+    pthread_mutex_unlock(&_timer_mutex);
+    return (is_active == true) ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    if (timer == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&_timer_mutex);
+    if (timer->is_active == true)
+    {
+        pthread_mutex_unlock(&_timer_mutex);
+        return ESP_ERR_INVALID_STATE;
+    }
+    _timer_wait_idle(timer);
+    for (struct esp_timer **item = &_timer_list; *item != NULL; item = &(*item)->next)
+    {
+        if (*item == timer)
+        {
+            *item = timer->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&_timer_mutex);
+    free(timer);
+    return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer)
+{
+    pthread_mutex_lock(&_timer_mutex);
+    bool is_active = timer->is_active;
+    pthread_mutex_unlock(&_timer_mutex);
+    return is_active;
+}
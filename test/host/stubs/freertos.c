@@ -0,0 +1,237 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include <stdlib.h>
+#include <time.h>
+
+#define TICK_PERIOD_US (1000000LL / configTICK_RATE_HZ)
+
+struct tskTaskControlBlock
+{
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint32_t notify_value;
+    TaskFunction_t task_code;
+    void *parameters;
+    bool is_created;
+};
+
+static __thread TaskHandle_t _current_task = NULL;
+
+static TaskHandle_t _task_alloc(void)
+{
+    TaskHandle_t task = calloc(1, sizeof(struct tskTaskControlBlock));
+    if (task == NULL)
+    {
+        return NULL;
+    }
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&task->cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+    pthread_mutex_init(&task->mutex, NULL);
+    return task;
+}
+
+static void _task_free(TaskHandle_t task)
+{
+    pthread_cond_destroy(&task->cond);
+    pthread_mutex_destroy(&task->mutex);
+    free(task);
+}
+
+static void *_task_entry(void *arg)
+{
+    TaskHandle_t task = arg;
+    _current_task = task;
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+    task->task_code(task->parameters);
+    return NULL;
+}
+
+static struct timespec _deadline_get(int64_t deadline_us)
+{
+    struct timespec deadline = {0};
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    int64_t now_us = esp_timer_get_time();
+    int64_t wait_ns = (deadline_us > now_us) ? (deadline_us - now_us) * 1000 : 0;
+    deadline.tv_sec += wait_ns / 1000000000;
+    deadline.tv_nsec += wait_ns % 1000000000;
+    if (deadline.tv_nsec >= 1000000000)
+    {
+        ++deadline.tv_sec;
+        deadline.tv_nsec -= 1000000000;
+    }
+    return deadline;
+}
+
+static int64_t _tick_deadline_get(TickType_t ticks)
+{
+    return ((int64_t)xTaskGetTickCount() + ticks) * TICK_PERIOD_US;
+}
+
+static void _mutex_cleanup(void *arg)
+{
+    pthread_mutex_unlock(arg);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t pxTaskCode, const char *pcName, uint32_t usStackDepth, void *pvParameters, UBaseType_t uxPriority, TaskHandle_t *pxCreatedTask, BaseType_t xCoreID)
+{
+    (void)pcName;
+    (void)usStackDepth;
+    (void)uxPriority;
+    (void)xCoreID;
+    TaskHandle_t task = _task_alloc();
+    if (task == NULL)
+    {
+        return pdFAIL;
+    }
+    task->task_code = pxTaskCode;
+    task->parameters = pvParameters;
+    task->is_created = true;
+    if (pxCreatedTask != NULL)
+    {
+        *pxCreatedTask = task;
+    }
+    if (pthread_create(&task->thread, NULL, _task_entry, task) != 0)
+    {
+        if (pxCreatedTask != NULL)
+        {
+            *pxCreatedTask = NULL;
+        }
+        _task_free(task);
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t pxTaskCode, const char *pcName, uint32_t ulStackDepth, void *pvParameters, UBaseType_t uxPriority, StackType_t *puxStackBuffer,
+                                           StaticTask_t *pxTaskBuffer, BaseType_t xCoreID)
+{
+    TaskHandle_t task = NULL;
+    if (puxStackBuffer == NULL || pxTaskBuffer == NULL)
+    {
+        return NULL;
+    }
+    xTaskCreatePinnedToCore(pxTaskCode, pcName, ulStackDepth, pvParameters, uxPriority, &task, xCoreID);
+    return task;
+}
+
+void vTaskDelete(TaskHandle_t xTaskToDelete)
+{
+    if (xTaskToDelete == NULL || xTaskToDelete == _current_task)
+    {
+        pthread_exit(NULL);
+    }
+    pthread_cancel(xTaskToDelete->thread);
+    pthread_join(xTaskToDelete->thread, NULL);
+    _task_free(xTaskToDelete);
+}
+
+void vTaskDelay(TickType_t xTicksToDelay)
+{
+    int64_t deadline_us = _tick_deadline_get(xTicksToDelay);
+    struct timespec deadline = _deadline_get(deadline_us);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) != 0)
+    {
+    }
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(esp_timer_get_time() / TICK_PERIOD_US);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    if (_current_task == NULL)
+    {
+        _current_task = _task_alloc();
+        _current_task->thread = pthread_self();
+    }
+    return _current_task;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask)
+{
+    (void)xTask;
+    return configMINIMAL_STACK_SIZE;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify)
+{
+    pthread_mutex_lock(&xTaskToNotify->mutex);
+    ++xTaskToNotify->notify_value;
+    pthread_cond_signal(&xTaskToNotify->cond);
+    pthread_mutex_unlock(&xTaskToNotify->mutex);
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    xTaskNotifyGive(xTaskToNotify);
+    if (pxHigherPriorityTaskWoken != NULL)
+    {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait)
+{
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    struct timespec deadline = _deadline_get((xTicksToWait == portMAX_DELAY) ? 0 : _tick_deadline_get(xTicksToWait));
+    uint32_t notify_value = 0;
+    pthread_mutex_lock(&task->mutex);
+    pthread_cleanup_push(_mutex_cleanup, &task->mutex);
+    if (task->is_created == true)
+    {
+        pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+    }
+    while (task->notify_value == 0 && xTicksToWait != 0)
+    {
+        if (xTicksToWait == portMAX_DELAY)
+        {
+            pthread_cond_wait(&task->cond, &task->mutex);
+        }
+        else if (pthread_cond_timedwait(&task->cond, &task->mutex, &deadline) != 0)
+        {
+            break;
+        }
+    }
+    if (task->is_created == true)
+    {
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+    }
+    notify_value = task->notify_value;
+    if (notify_value != 0)
+    {
+        task->notify_value = (xClearCountOnExit == pdTRUE) ? 0 : notify_value - 1;
+    }
+    pthread_cleanup_pop(1);
+    return notify_value;
+}
+
+void vTaskSetTimeOutState(TimeOut_t *pxTimeOut)
+{
+    pxTimeOut->xTimeOnEntering = xTaskGetTickCount();
+}
+
+BaseType_t xTaskCheckForTimeOut(TimeOut_t *pxTimeOut, TickType_t *pxTicksToWait)
+{
+    if (*pxTicksToWait == portMAX_DELAY)
+    {
+        return pdFALSE;
+    }
+    TickType_t current_tick = xTaskGetTickCount();
+    TickType_t elapsed = current_tick - pxTimeOut->xTimeOnEntering;
+    if (elapsed < *pxTicksToWait)
+    {
+        *pxTicksToWait -= elapsed;
+        pxTimeOut->xTimeOnEntering = current_tick;
+        return pdFALSE;
+    }
+    *pxTicksToWait = 0;
+    return pdTRUE;
+}
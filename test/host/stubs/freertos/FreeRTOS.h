@@ -0,0 +1,52 @@
+#pragma once
+
+#include <pthread.h>
+#include "esp_err.h"
+#include "esp_attr.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t StackType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdFAIL 0
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define configTICK_RATE_HZ CONFIG_FREERTOS_HZ
+#define configMINIMAL_STACK_SIZE 768
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(xTimeInMs) ((TickType_t)(((TickType_t)(xTimeInMs) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000U))
+#define tskNO_AFFINITY 0x7fffffff
+#define portNUM_PROCESSORS 2
+
+typedef struct
+{
+    pthread_mutex_t mutex;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP}
+
+#define taskENTER_CRITICAL(mux) pthread_mutex_lock(&(mux)->mutex)
+#define taskEXIT_CRITICAL(mux) pthread_mutex_unlock(&(mux)->mutex)
+#define taskENTER_CRITICAL_ISR(mux) taskENTER_CRITICAL(mux)
+#define taskEXIT_CRITICAL_ISR(mux) taskEXIT_CRITICAL(mux)
+#define portENTER_CRITICAL_SAFE(mux) taskENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL_SAFE(mux) taskEXIT_CRITICAL(mux)
+#define portYIELD_FROM_ISR(...) ((void)0)
+
+typedef struct
+{
+    void *dummy[16];
+} StaticTask_t;
+
+#ifdef __cplusplus
+}
+#endif
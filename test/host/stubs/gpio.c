@@ -0,0 +1,134 @@
+#include "driver/gpio.h"
+#include "host.h"
+#include <pthread.h>
+
+typedef struct
+{
+    int level;
+    gpio_int_type_t intr_type;
+    gpio_isr_t isr_handler;
+    void *isr_arg;
+} gpio_pin_t;
+
+void pcnt_host_edge(int gpio_num, int level);
+
+static pthread_mutex_t _isr_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+static gpio_pin_t _gpio_pin[GPIO_NUM_MAX] = {0};
+static bool _is_isr_service_installed = false;
+
+void host_isr_lock(void)
+{
+    pthread_mutex_lock(&_isr_mutex);
+}
+
+void host_isr_unlock(void)
+{
+    pthread_mutex_unlock(&_isr_mutex);
+}
+
+void host_gpio_set_level(gpio_num_t gpio_num, int level)
+{
+    host_isr_lock();
+    gpio_pin_t *pin = &_gpio_pin[gpio_num];
+    level = (level != 0);
+    if (pin->level == level)
+    {
+        host_isr_unlock();
+        return;
+    }
+    __atomic_store_n(&pin->level, level, __ATOMIC_RELEASE);
+    pcnt_host_edge(gpio_num, level);
+    gpio_int_type_t intr_type = pin->intr_type;
+    if (pin->isr_handler != NULL && (intr_type == GPIO_INTR_ANYEDGE || (intr_type == GPIO_INTR_POSEDGE && level == 1) || (intr_type == GPIO_INTR_NEGEDGE && level == 0)))
+    {
+        pin->isr_handler(pin->isr_arg);
+    }
+    host_isr_unlock();
+}
+
+esp_err_t gpio_config(const gpio_config_t *pGPIOConfig)
+{
+    if (pGPIOConfig == NULL || pGPIOConfig->pin_bit_mask == 0 || pGPIOConfig->pin_bit_mask >= (1ULL << GPIO_NUM_MAX))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    host_isr_lock();
+    for (uint8_t i = 0; i < GPIO_NUM_MAX; ++i)
+    {
+        if ((pGPIOConfig->pin_bit_mask & (1ULL << i)) != 0)
+        {
+            _gpio_pin[i].intr_type = pGPIOConfig->intr_type;
+        }
+    }
+    host_isr_unlock();
+    return ESP_OK;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    host_isr_lock();
+    _gpio_pin[gpio_num].intr_type = GPIO_INTR_DISABLE;
+    _gpio_pin[gpio_num].isr_handler = NULL;
+    _gpio_pin[gpio_num].isr_arg = NULL;
+    host_isr_unlock();
+    return ESP_OK;
+}
+
+esp_err_t gpio_pullup_dis(gpio_num_t gpio_num)
+{
+    return (gpio_num >= 0 && gpio_num < GPIO_NUM_MAX) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+int gpio_get_level(gpio_num_t gpio_num)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX)
+    {
+        return 0;
+    }
+    return __atomic_load_n(&_gpio_pin[gpio_num].level, __ATOMIC_ACQUIRE);
+}
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags)
+{
+    (void)intr_alloc_flags;
+    host_isr_lock();
+    esp_err_t err = (_is_isr_service_installed == true) ? ESP_ERR_INVALID_STATE : ESP_OK;
+    _is_isr_service_installed = true;
+    host_isr_unlock();
+    return err;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void *args)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    host_isr_lock();
+    if (_is_isr_service_installed == false)
+    {
+        host_isr_unlock();
+        return ESP_ERR_INVALID_STATE;
+    }
+    _gpio_pin[gpio_num].isr_handler = isr_handler;
+    _gpio_pin[gpio_num].isr_arg = args;
+    host_isr_unlock();
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio_num)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    host_isr_lock();
+    _gpio_pin[gpio_num].isr_handler = NULL;
+    _gpio_pin[gpio_num].isr_arg = NULL;
+    host_isr_unlock();
+    return ESP_OK;
+}
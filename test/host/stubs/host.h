@@ -0,0 +1,48 @@
+#pragma once
+
+#include "driver/gpio.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Drive an input pin from the test side.
+ *
+ * @note Runs in simulated interrupt context: PCNT units counting on the pin and the GPIO isr handler of the pin are serviced before return.
+ */
+void host_gpio_set_level(gpio_num_t gpio_num, int level);
+
+/**
+ * @brief Serialize test code with simulated interrupts.
+ */
+void host_isr_lock(void);
+void host_isr_unlock(void);
+
+/**
+ * @brief Erase the simulated NVS partition.
+ */
+void host_nvs_erase(void);
+
+/**
+ * @brief Simulate a power cycle: NVS values written but not committed are lost.
+ */
+void host_nvs_power_cycle(void);
+
+/**
+ * @brief Read a committed NVS value.
+ *
+ * @return true if the key exists in committed storage.
+ */
+bool host_nvs_get_u32(const char *namespace_name, const char *key, uint32_t *out_value);
+
+/**
+ * @brief Number of NVS set and commit calls since the last erase.
+ */
+uint32_t host_nvs_set_count(void);
+uint32_t host_nvs_commit_count(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,216 @@
+#include "nvs.h"
+#include "host.h"
+#include <pthread.h>
+#include <string.h>
+
+#define NVS_MAX_ENTRIES 64
+#define NVS_MAX_HANDLES 8
+
+typedef struct
+{
+    char namespace_name[NVS_KEY_NAME_MAX_SIZE];
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    uint32_t value;
+    uint32_t flash_value;
+    bool is_written;
+    bool is_flashed;
+} nvs_entry_t;
+
+typedef struct
+{
+    char namespace_name[NVS_KEY_NAME_MAX_SIZE];
+    nvs_open_mode_t open_mode;
+    bool is_open;
+} nvs_slot_t;
+
+static pthread_mutex_t _nvs_mutex = PTHREAD_MUTEX_INITIALIZER;
+static nvs_entry_t _nvs_entry[NVS_MAX_ENTRIES] = {0};
+static nvs_slot_t _nvs_slot[NVS_MAX_HANDLES] = {0};
+static uint32_t _nvs_set_count = 0;
+static uint32_t _nvs_commit_count = 0;
+
+static nvs_entry_t *_entry_find(const char *namespace_name, const char *key)
+{
+    for (uint8_t i = 0; i < NVS_MAX_ENTRIES; ++i)
+    {
+        nvs_entry_t *entry = &_nvs_entry[i];
+        if ((entry->is_written == true || entry->is_flashed == true) && strcmp(entry->namespace_name, namespace_name) == 0 && (key == NULL || strcmp(entry->key, key) == 0))
+        {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static nvs_slot_t *_slot_get(nvs_handle_t handle)
+{
+    if (handle == 0 || handle > NVS_MAX_HANDLES || _nvs_slot[handle - 1].is_open == false)
+    {
+        return NULL;
+    }
+    return &_nvs_slot[handle - 1];
+}
+
+esp_err_t nvs_open(const char *namespace_name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    if (namespace_name == NULL || out_handle == NULL || strlen(namespace_name) >= NVS_KEY_NAME_MAX_SIZE)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&_nvs_mutex);
+    if (open_mode == NVS_READONLY && _entry_find(namespace_name, NULL) == NULL)
+    {
+        pthread_mutex_unlock(&_nvs_mutex);
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    for (uint8_t i = 0; i < NVS_MAX_HANDLES; ++i)
+    {
+        nvs_slot_t *slot = &_nvs_slot[i];
+        if (slot->is_open == false)
+        {
+            strcpy(slot->namespace_name, namespace_name);
+            slot->open_mode = open_mode;
+            slot->is_open = true;
+            *out_handle = i + 1;
+            pthread_mutex_unlock(&_nvs_mutex);
+            return ESP_OK;
+        }
+    }
+    pthread_mutex_unlock(&_nvs_mutex);
+    return ESP_ERR_NO_MEM;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    pthread_mutex_lock(&_nvs_mutex);
+    nvs_slot_t *slot = _slot_get(handle);
+    if (slot != NULL)
+    {
+        slot->is_open = false;
+    }
+    pthread_mutex_unlock(&_nvs_mutex);
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char *key, uint32_t *out_value)
+{
+    pthread_mutex_lock(&_nvs_mutex);
+    nvs_slot_t *slot = _slot_get(handle);
+    if (slot == NULL)
+    {
+        pthread_mutex_unlock(&_nvs_mutex);
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    nvs_entry_t *entry = _entry_find(slot->namespace_name, key);
+    if (entry == NULL || entry->is_written == false)
+    {
+        pthread_mutex_unlock(&_nvs_mutex);
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    *out_value = entry->value;
+    pthread_mutex_unlock(&_nvs_mutex);
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char *key, uint32_t value)
+{
+    pthread_mutex_lock(&_nvs_mutex);
+    nvs_slot_t *slot = _slot_get(handle);
+    if (slot == NULL || slot->open_mode == NVS_READONLY)
+    {
+        pthread_mutex_unlock(&_nvs_mutex);
+        return (slot == NULL) ? ESP_ERR_NVS_INVALID_HANDLE : ESP_ERR_NVS_READ_ONLY;
+    }
+    nvs_entry_t *entry = _entry_find(slot->namespace_name, key);
+    for (uint8_t i = 0; entry == NULL && i < NVS_MAX_ENTRIES; ++i)
+    {
+        if (_nvs_entry[i].is_written == false && _nvs_entry[i].is_flashed == false)
+        {
+            entry = &_nvs_entry[i];
+            strcpy(entry->namespace_name, slot->namespace_name);
+            strncpy(entry->key, key, NVS_KEY_NAME_MAX_SIZE - 1);
+        }
+    }
+    if (entry == NULL)
+    {
+        pthread_mutex_unlock(&_nvs_mutex);
+        return ESP_ERR_NO_MEM;
+    }
+    entry->value = value;
+    entry->is_written = true;
+    ++_nvs_set_count;
+    pthread_mutex_unlock(&_nvs_mutex);
+    return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    pthread_mutex_lock(&_nvs_mutex);
+    nvs_slot_t *slot = _slot_get(handle);
+    if (slot == NULL)
+    {
+        pthread_mutex_unlock(&_nvs_mutex);
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    for (uint8_t i = 0; i < NVS_MAX_ENTRIES; ++i)
+    {
+        nvs_entry_t *entry = &_nvs_entry[i];
+        if (entry->is_written == true && strcmp(entry->namespace_name, slot->namespace_name) == 0)
+        {
+            entry->flash_value = entry->value;
+            entry->is_flashed = true;
+        }
+    }
+    ++_nvs_commit_count;
+    pthread_mutex_unlock(&_nvs_mutex);
+    return ESP_OK;
+}
+
+void host_nvs_erase(void)
+{
+    pthread_mutex_lock(&_nvs_mutex);
+    memset(_nvs_entry, 0, sizeof(_nvs_entry));
+    _nvs_set_count = 0;
+    _nvs_commit_count = 0;
+    pthread_mutex_unlock(&_nvs_mutex);
+}
+
+void host_nvs_power_cycle(void)
+{
+    pthread_mutex_lock(&_nvs_mutex);
+    for (uint8_t i = 0; i < NVS_MAX_ENTRIES; ++i)
+    {
+        nvs_entry_t *entry = &_nvs_entry[i];
+        entry->value = entry->flash_value;
+        entry->is_written = entry->is_flashed;
+    }
+    pthread_mutex_unlock(&_nvs_mutex);
+}
+
+bool host_nvs_get_u32(const char *namespace_name, const char *key, uint32_t *out_value)
+{
+    pthread_mutex_lock(&_nvs_mutex);
+    nvs_entry_t *entry = _entry_find(namespace_name, key);
+    bool is_found = (entry != NULL && entry->is_flashed == true);
+    if (is_found == true)
+    {
+        *out_value = entry->flash_value;
+    }
+    pthread_mutex_unlock(&_nvs_mutex);
+    return is_found;
+}
+
+uint32_t host_nvs_set_count(void)
+{
+    pthread_mutex_lock(&_nvs_mutex);
+    uint32_t set_count = _nvs_set_count;
+    pthread_mutex_unlock(&_nvs_mutex);
+    return set_count;
+}
+
+uint32_t host_nvs_commit_count(void)
+{
+    pthread_mutex_lock(&_nvs_mutex);
+    uint32_t commit_count = _nvs_commit_count;
+    pthread_mutex_unlock(&_nvs_mutex);
+    return commit_count;
+}
@@ -0,0 +1,377 @@
+#include "driver/pulse_cnt.h"
+#include "driver/gpio.h"
+#include <pthread.h>
+
+#define PCNT_UNIT_MAX 8
+#define PCNT_CHANNEL_MAX 2
+#define PCNT_WATCH_POINT_MAX 5
+
+struct pcnt_chan_t
+{
+    pcnt_unit_handle_t unit;
+    int edge_gpio_num;
+    int level_gpio_num;
+    pcnt_channel_edge_action_t edge_action[2];
+    pcnt_channel_level_action_t level_action[2];
+    bool is_used;
+};
+
+struct pcnt_unit_t
+{
+    pthread_mutex_t mutex;
+    int low_limit;
+    int high_limit;
+    bool accum_count;
+    int count;
+    int accum_value;
+    int watch_point[PCNT_WATCH_POINT_MAX];
+    uint8_t watch_point_quantity;
+    pcnt_watch_cb_t on_reach;
+    void *user_data;
+    bool is_isr_installed;
+    bool is_enabled;
+    bool is_started;
+    bool is_used;
+    struct pcnt_chan_t channel[PCNT_CHANNEL_MAX];
+};
+
+void pcnt_host_edge(int gpio_num, int level);
+
+static pthread_mutex_t _pcnt_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct pcnt_unit_t _pcnt_unit[PCNT_UNIT_MAX] = {0};
+
+static bool _watch_point_find(const struct pcnt_unit_t *unit, int value)
+{
+    for (uint8_t i = 0; i < unit->watch_point_quantity; ++i)
+    {
+        if (unit->watch_point[i] == value)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int _channel_delta(const struct pcnt_chan_t *channel, int level)
+{
+    pcnt_channel_edge_action_t edge_action = channel->edge_action[(level == 1) ? 0 : 1];
+    pcnt_channel_level_action_t level_action = channel->level_action[(gpio_get_level((gpio_num_t)channel->level_gpio_num) == 1) ? 0 : 1];
+    int delta = (edge_action == PCNT_CHANNEL_EDGE_ACTION_INCREASE) ? 1 : (edge_action == PCNT_CHANNEL_EDGE_ACTION_DECREASE) ? -1 : 0;
+    if (level_action == PCNT_CHANNEL_LEVEL_ACTION_INVERSE)
+    {
+        delta = -delta;
+    }
+    else if (level_action == PCNT_CHANNEL_LEVEL_ACTION_HOLD)
+    {
+        delta = 0;
+    }
+    return delta;
+}
+
+void pcnt_host_edge(int gpio_num, int level)
+{
+    for (uint8_t i = 0; i < PCNT_UNIT_MAX; ++i)
+    {
+        struct pcnt_unit_t *unit = &_pcnt_unit[i];
+        pthread_mutex_lock(&unit->mutex);
+        if (unit->is_used == false || unit->is_started == false)
+        {
+            pthread_mutex_unlock(&unit->mutex);
+            continue;
+        }
+        int delta = 0;
+        for (uint8_t j = 0; j < PCNT_CHANNEL_MAX; ++j)
+        {
+            if (unit->channel[j].is_used == true && unit->channel[j].edge_gpio_num == gpio_num)
+            {
+                delta += _channel_delta(&unit->channel[j], level);
+            }
+        }
+        if (delta == 0)
+        {
+            pthread_mutex_unlock(&unit->mutex);
+            continue;
+        }
+        unit->count += delta;
+        int watch_point_value = unit->count;
+        bool is_limit = (unit->count >= unit->high_limit || unit->count <= unit->low_limit);
+        bool is_event = (unit->is_isr_installed == true && _watch_point_find(unit, watch_point_value) == true);
+        if (is_limit == true)
+        {
+            unit->count = 0;
+            if (is_event == true && unit->accum_count == true)
+            {
+                unit->accum_value += watch_point_value;
+            }
+        }
+        pcnt_watch_cb_t on_reach = unit->on_reach;
+        void *user_data = unit->user_data;
+        pthread_mutex_unlock(&unit->mutex);
+        if (is_event == true && on_reach != NULL)
+        {
+            pcnt_watch_event_data_t edata = {.watch_point_value = watch_point_value};
+            on_reach(unit, &edata, user_data);
+        }
+    }
+}
+
+esp_err_t pcnt_new_unit(const pcnt_unit_config_t *config, pcnt_unit_handle_t *ret_unit)
+{
+    if (config == NULL || ret_unit == NULL || config->low_limit >= 0 || config->high_limit <= 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&_pcnt_mutex);
+    for (uint8_t i = 0; i < PCNT_UNIT_MAX; ++i)
+    {
+        struct pcnt_unit_t *unit = &_pcnt_unit[i];
+        if (unit->is_used == false)
+        {
+            pthread_mutex_lock(&unit->mutex);
+            unit->low_limit = config->low_limit;
+            unit->high_limit = config->high_limit;
+            unit->accum_count = config->flags.accum_count;
+            unit->count = 0;
+            unit->accum_value = 0;
+            unit->watch_point_quantity = 0;
+            unit->on_reach = NULL;
+            unit->user_data = NULL;
+            unit->is_isr_installed = false;
+            unit->is_enabled = false;
+            unit->is_started = false;
+            unit->channel[0].is_used = false;
+            unit->channel[1].is_used = false;
+            unit->is_used = true;
+            pthread_mutex_unlock(&unit->mutex);
+            pthread_mutex_unlock(&_pcnt_mutex);
+            *ret_unit = unit;
+            return ESP_OK;
+        }
+    }
+    pthread_mutex_unlock(&_pcnt_mutex);
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t pcnt_del_unit(pcnt_unit_handle_t unit)
+{
+    if (unit == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&unit->mutex);
+    if (unit->is_enabled == true || unit->channel[0].is_used == true || unit->channel[1].is_used == true)
+    {
+        pthread_mutex_unlock(&unit->mutex);
+        return ESP_ERR_INVALID_STATE;
+    }
+    unit->is_used = false;
+    pthread_mutex_unlock(&unit->mutex);
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_set_glitch_filter(pcnt_unit_handle_t unit, const pcnt_glitch_filter_config_t *config)
+{
+    (void)config;
+    return (unit != NULL) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t pcnt_unit_enable(pcnt_unit_handle_t unit)
+{
+    if (unit == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&unit->mutex);
+    esp_err_t err = (unit->is_enabled == true) ? ESP_ERR_INVALID_STATE : ESP_OK;
+    unit->is_enabled = true;
+    pthread_mutex_unlock(&unit->mutex);
+    return err;
+}
+
+esp_err_t pcnt_unit_disable(pcnt_unit_handle_t unit)
+{
+    if (unit == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&unit->mutex);
+    esp_err_t err = (unit->is_enabled == false) ? ESP_ERR_INVALID_STATE : ESP_OK;
+    unit->is_enabled = false;
+    unit->is_started = false;
+    pthread_mutex_unlock(&unit->mutex);
+    return err;
+}
+
+esp_err_t pcnt_unit_start(pcnt_unit_handle_t unit)
+{
+    if (unit == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&unit->mutex);
+    esp_err_t err = (unit->is_enabled == false) ? ESP_ERR_INVALID_STATE : ESP_OK;
+    unit->is_started = unit->is_enabled;
+    pthread_mutex_unlock(&unit->mutex);
+    return err;
+}
+
+esp_err_t pcnt_unit_stop(pcnt_unit_handle_t unit)
+{
+    if (unit == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&unit->mutex);
+    esp_err_t err = (unit->is_enabled == false) ? ESP_ERR_INVALID_STATE : ESP_OK;
+    unit->is_started = false;
+    pthread_mutex_unlock(&unit->mutex);
+    return err;
+}
+
+esp_err_t pcnt_unit_clear_count(pcnt_unit_handle_t unit)
+{
+    if (unit == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&unit->mutex);
+    unit->count = 0;
+    unit->accum_value = 0;
+    pthread_mutex_unlock(&unit->mutex);
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_get_count(pcnt_unit_handle_t unit, int *value)
+{
+    if (unit == NULL || value == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&unit->mutex);
+    *value = unit->accum_value + unit->count;
+    pthread_mutex_unlock(&unit->mutex);
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_register_event_callbacks(pcnt_unit_handle_t unit, const pcnt_event_callbacks_t *cbs, void *user_data)
+{
+    if (unit == NULL || cbs == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&unit->mutex);
+    if (unit->is_enabled == true)
+    {
+        pthread_mutex_unlock(&unit->mutex);
+        return ESP_ERR_INVALID_STATE;
+    }
+    unit->on_reach = cbs->on_reach;
+    unit->user_data = user_data;
+    unit->is_isr_installed = true;
+    pthread_mutex_unlock(&unit->mutex);
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_add_watch_point(pcnt_unit_handle_t unit, int watch_point)
+{
+    if (unit == NULL || watch_point < unit->low_limit || watch_point > unit->high_limit)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&unit->mutex);
+    if (_watch_point_find(unit, watch_point) == true || unit->watch_point_quantity == PCNT_WATCH_POINT_MAX)
+    {
+        pthread_mutex_unlock(&unit->mutex);
+        return ESP_ERR_INVALID_STATE;
+    }
+    unit->watch_point[unit->watch_point_quantity++] = watch_point;
+    pthread_mutex_unlock(&unit->mutex);
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_remove_watch_point(pcnt_unit_handle_t unit, int watch_point)
+{
+    if (unit == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&unit->mutex);
+    for (uint8_t i = 0; i < unit->watch_point_quantity; ++i)
+    {
+        if (unit->watch_point[i] == watch_point)
+        {
+            unit->watch_point[i] = unit->watch_point[--unit->watch_point_quantity];
+            pthread_mutex_unlock(&unit->mutex);
+            return ESP_OK;
+        }
+    }
+    pthread_mutex_unlock(&unit->mutex);
+    return ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t pcnt_new_channel(pcnt_unit_handle_t unit, const pcnt_chan_config_t *config, pcnt_channel_handle_t *ret_chan)
+{
+    if (unit == NULL || config == NULL || ret_chan == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&unit->mutex);
+    for (uint8_t i = 0; i < PCNT_CHANNEL_MAX; ++i)
+    {
+        struct pcnt_chan_t *channel = &unit->channel[i];
+        if (channel->is_used == false)
+        {
+            channel->unit = unit;
+            channel->edge_gpio_num = config->edge_gpio_num;
+            channel->level_gpio_num = config->level_gpio_num;
+            channel->edge_action[0] = PCNT_CHANNEL_EDGE_ACTION_HOLD;
+            channel->edge_action[1] = PCNT_CHANNEL_EDGE_ACTION_HOLD;
+            channel->level_action[0] = PCNT_CHANNEL_LEVEL_ACTION_KEEP;
+            channel->level_action[1] = PCNT_CHANNEL_LEVEL_ACTION_KEEP;
+            channel->is_used = true;
+            pthread_mutex_unlock(&unit->mutex);
+            *ret_chan = channel;
+            return ESP_OK;
+        }
+    }
+    pthread_mutex_unlock(&unit->mutex);
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t pcnt_del_channel(pcnt_channel_handle_t chan)
+{
+    if (chan == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&chan->unit->mutex);
+    chan->is_used = false;
+    pthread_mutex_unlock(&chan->unit->mutex);
+    return ESP_OK;
+}
+
+esp_err_t pcnt_channel_set_edge_action(pcnt_channel_handle_t chan, pcnt_channel_edge_action_t pos_act, pcnt_channel_edge_action_t neg_act)
+{
+    if (chan == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&chan->unit->mutex);
+    chan->edge_action[0] = pos_act;
+    chan->edge_action[1] = neg_act;
+    pthread_mutex_unlock(&chan->unit->mutex);
+    return ESP_OK;
+}
+
+esp_err_t pcnt_channel_set_level_action(pcnt_channel_handle_t chan, pcnt_channel_level_action_t high_act, pcnt_channel_level_action_t low_act)
+{
+    if (chan == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&chan->unit->mutex);
+    chan->level_action[0] = high_act;
+    chan->level_action[1] = low_act;
+    pthread_mutex_unlock(&chan->unit->mutex);
+    return ESP_OK;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#define CONFIG_ZH_ENCODER_MAX_QUANTITY 16
+#define CONFIG_ZH_ENCODER_ISR_IN_IRAM 1
+#define CONFIG_ZH_ENCODER_TASK_IN_IRAM 1
+#define CONFIG_FREERTOS_HZ 100
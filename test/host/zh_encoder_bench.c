@@ -0,0 +1,161 @@
+#include "zh_encoder.h"
+#include "quadrature.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define BENCH_MAX_ENCODERS 8
+#define BENCH_STAMP_SIZE 65536
+#define BENCH_SAMPLE_SIZE 1048576
+
+typedef struct
+{
+    zh_encoder_handle_t handle;
+    quadrature_t quadrature;
+    int64_t stamp[BENCH_STAMP_SIZE];
+    int64_t step_count;
+    volatile uint32_t event_count;
+} bench_encoder_t;
+
+static const gpio_num_t _a_gpio[BENCH_MAX_ENCODERS] = {GPIO_NUM_0, GPIO_NUM_2, GPIO_NUM_4, GPIO_NUM_12, GPIO_NUM_14, GPIO_NUM_18, GPIO_NUM_21, GPIO_NUM_25};
+static const gpio_num_t _b_gpio[BENCH_MAX_ENCODERS] = {GPIO_NUM_1, GPIO_NUM_3, GPIO_NUM_5, GPIO_NUM_13, GPIO_NUM_15, GPIO_NUM_19, GPIO_NUM_22, GPIO_NUM_26};
+static bench_encoder_t _encoder[BENCH_MAX_ENCODERS] = {0};
+static uint32_t _latency[BENCH_SAMPLE_SIZE] = {0};
+static volatile uint32_t _latency_count = 0;
+
+static void _event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data)
+{
+    (void)arg;
+    (void)event_base;
+    (void)event_id;
+    int64_t event_time = esp_timer_get_time();
+    const zh_encoder_event_on_isr_t *event = event_data;
+    bench_encoder_t *encoder = &_encoder[event->encoder_number - 1];
+    int64_t step = (int64_t)event->encoder_position;
+    __atomic_fetch_add(&encoder->event_count, 1, __ATOMIC_RELAXED);
+    if (step <= 0)
+    {
+        return;
+    }
+    int64_t stamp = __atomic_load_n(&encoder->stamp[step % BENCH_STAMP_SIZE], __ATOMIC_ACQUIRE);
+    uint32_t index = __atomic_fetch_add(&_latency_count, 1, __ATOMIC_RELAXED);
+    if (index < BENCH_SAMPLE_SIZE)
+    {
+        _latency[index] = (uint32_t)(event_time - stamp);
+    }
+}
+
+static int _latency_compare(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t _percentile(const uint32_t *sorted, uint32_t quantity, uint32_t percent)
+{
+    if (quantity == 0)
+    {
+        return 0;
+    }
+    uint32_t index = (uint32_t)(((uint64_t)quantity * percent + 99) / 100);
+    return sorted[(index > 0) ? index - 1 : 0];
+}
+
+static int _bench_run(uint8_t quantity, uint32_t duration_ms, uint32_t step_rate)
+{
+    zh_encoder_init_config_t config[BENCH_MAX_ENCODERS];
+    zh_encoder_handle_t handle[BENCH_MAX_ENCODERS] = {0};
+    for (uint8_t i = 0; i < quantity; ++i)
+    {
+        config[i] = (zh_encoder_init_config_t)ZH_ENCODER_INIT_CONFIG_DEFAULT();
+        config[i].a_gpio_number = _a_gpio[i];
+        config[i].b_gpio_number = _b_gpio[i];
+        config[i].encoder_number = i + 1;
+        config[i].encoder_min_value = -1000000;
+        config[i].encoder_max_value = 1000000;
+        config[i].task_priority = 5;
+        config[i].stack_size = 4096;
+    }
+    if (zh_encoder_init_many(config, handle, quantity) != ESP_OK)
+    {
+        fprintf(stderr, "Encoder initialization failed.\n");
+        return 1;
+    }
+    _latency_count = 0;
+    for (uint8_t i = 0; i < quantity; ++i)
+    {
+        _encoder[i].handle = handle[i];
+        _encoder[i].step_count = 0;
+        _encoder[i].event_count = 0;
+        quadrature_init(&_encoder[i].quadrature, _a_gpio[i], _b_gpio[i]);
+    }
+    int64_t start_time = esp_timer_get_time();
+    int64_t end_time = start_time + duration_ms * 1000LL;
+    for (int64_t current_time = start_time; current_time < end_time; current_time = esp_timer_get_time())
+    {
+        int64_t target = (step_rate == 0) ? INT64_MAX : (current_time - start_time) * step_rate / 1000000;
+        bool is_idle = true;
+        for (uint8_t i = 0; i < quantity; ++i)
+        {
+            bench_encoder_t *encoder = &_encoder[i];
+            if (encoder->step_count >= target)
+            {
+                continue;
+            }
+            is_idle = false;
+            int64_t step = ++encoder->step_count;
+            __atomic_store_n(&encoder->stamp[step % BENCH_STAMP_SIZE], esp_timer_get_time(), __ATOMIC_RELEASE);
+            quadrature_cycles(&encoder->quadrature, 1);
+        }
+        if (is_idle == true)
+        {
+            usleep(50);
+        }
+    }
+    double elapsed = (esp_timer_get_time() - start_time) / 1000000.0;
+    vTaskDelay(pdMS_TO_TICKS(200));
+    int64_t step_count = 0;
+    uint32_t event_count = 0;
+    uint32_t drop_count = 0;
+    int64_t mismatch_count = 0;
+    for (uint8_t i = 0; i < quantity; ++i)
+    {
+        bench_encoder_t *encoder = &_encoder[i];
+        zh_encoder_metrics_t metrics = {0};
+        zh_encoder_get_metrics(&handle[i], &metrics);
+        int64_t ticks = 0;
+        zh_encoder_get_ticks(&handle[i], &ticks);
+        step_count += encoder->step_count;
+        event_count += encoder->event_count;
+        drop_count += metrics.step_drop_count + metrics.event_post_error;
+        mismatch_count += llabs(encoder->step_count - ticks);
+    }
+    uint32_t sample_count = (_latency_count < BENCH_SAMPLE_SIZE) ? _latency_count : BENCH_SAMPLE_SIZE;
+    qsort(_latency, sample_count, sizeof(uint32_t), _latency_compare);
+    printf("%8u %10lld %12.0f %10u %12.0f %8u %8u %8u %8u %8u %10lld\n", quantity, (long long)step_count, step_count / elapsed, event_count, event_count / elapsed, _percentile(_latency, sample_count, 50),
+           _percentile(_latency, sample_count, 90), _percentile(_latency, sample_count, 99), _percentile(_latency, sample_count, 100), drop_count, (long long)mismatch_count);
+    for (uint8_t i = 0; i < quantity; ++i)
+    {
+        zh_encoder_deinit(&handle[i]);
+    }
+    return (drop_count != 0 || mismatch_count != 0) ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t duration_ms = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : 1000;
+    uint32_t step_rate = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 10) : 10000;
+    esp_event_loop_create_default();
+    esp_event_handler_instance_t instance = NULL;
+    esp_event_handler_instance_register(ZH_ENCODER, ZH_ENCODER_EVENT, &_event_handler, NULL, &instance);
+    printf("Duration %u ms per run, step rate %u steps/s per encoder (0 = unthrottled).\n", duration_ms, step_rate);
+    printf("%8s %10s %12s %10s %12s %8s %8s %8s %8s %8s %10s\n", "encoders", "steps", "steps/s", "events", "events/s", "p50 us", "p90 us", "p99 us", "max us", "drops", "mismatch");
+    int result = 0;
+    for (uint8_t quantity = 1; quantity <= BENCH_MAX_ENCODERS; ++quantity)
+    {
+        result |= _bench_run(quantity, duration_ms, step_rate);
+    }
+    esp_event_handler_instance_unregister(ZH_ENCODER, ZH_ENCODER_EVENT, instance);
+    return result;
+}
@@ -0,0 +1,81 @@
+#include "zh_encoder.hpp"
+#include "quadrature.h"
+#include <cstdio>
+#include <type_traits>
+
+#define CHECK(cond)                                                              \
+    if (!(cond))                                                                 \
+    {                                                                            \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        ++_failures;                                                             \
+        return;                                                                  \
+    }
+
+#define WAIT_FOR(cond, timeout_ms)                                                                                        \
+    for (int64_t _deadline = esp_timer_get_time() + (timeout_ms) * 1000LL; !(cond) && esp_timer_get_time() < _deadline;)  \
+    {                                                                                                                     \
+        vTaskDelay(1);                                                                                                    \
+    }
+
+struct EventCapture
+{
+    volatile uint32_t count = 0;
+    volatile float position = 0;
+};
+
+constexpr zh::EncoderConfig ENCODER_CONFIG{.a_gpio_number = GPIO_NUM_4, .b_gpio_number = GPIO_NUM_16, .encoder_min_value = -100, .encoder_max_value = 100, .encoder_number = 1};
+
+static_assert(ENCODER_CONFIG.is_valid());
+static_assert(!zh::EncoderConfig{.a_gpio_number = GPIO_NUM_4, .b_gpio_number = GPIO_NUM_4, .encoder_number = 1}.is_gpio_valid());
+static_assert(!zh::EncoderConfig{.a_gpio_number = GPIO_NUM_4, .b_gpio_number = GPIO_NUM_16, .s_gpio_number = GPIO_NUM_4, .encoder_number = 1}.is_gpio_valid());
+static_assert(!zh::EncoderConfig{.a_gpio_number = GPIO_NUM_4, .b_gpio_number = GPIO_NUM_16, .encoder_min_value = 10, .encoder_max_value = -10, .encoder_number = 1}.is_valid());
+static_assert(!zh::EncoderConfig{.a_gpio_number = GPIO_NUM_4, .b_gpio_number = GPIO_NUM_16, .encoder_number = 0}.is_valid());
+static_assert(zh::Encoder<ENCODER_CONFIG>::number() == 1);
+static_assert(std::is_same_v<zh::EventSubscription<ZH_INDEX_EVENT>::Data, zh_encoder_index_event_t>);
+
+static int _failures = 0;
+
+static void _test_encoder(void)
+{
+    EventCapture capture;
+    zh::EventSubscription<ZH_ENCODER_EVENT> subscription(
+        [](const zh_encoder_event_on_isr_t &event, void *arg)
+        {
+            EventCapture *capture = static_cast<EventCapture *>(arg);
+            capture->position = event.encoder_position;
+            __atomic_fetch_add(&capture->count, 1, __ATOMIC_RELEASE);
+        },
+        &capture);
+    CHECK(subscription.status() == ESP_OK);
+    {
+        zh::Encoder<ENCODER_CONFIG> encoder;
+        CHECK(encoder);
+        CHECK(encoder.handle()->encoder_number == 1);
+        quadrature_t quadrature = {};
+        quadrature_init(&quadrature, GPIO_NUM_4, GPIO_NUM_16);
+        quadrature_cycles(&quadrature, 3);
+        WAIT_FOR(encoder.ticks() == 3 && capture.position == 3, 1000);
+        CHECK(encoder.ticks() == 3);
+        CHECK(encoder.position() == 3 && encoder.value() == 3);
+        CHECK(capture.position == 3 && capture.count > 0);
+        CHECK(encoder.set(-20) == ESP_OK && encoder.snapshot().encoder_position == -20);
+        zh::Encoder<ENCODER_CONFIG> duplicate;
+        CHECK(!duplicate && duplicate.status() != ESP_OK);
+    }
+    zh::Encoder<ENCODER_CONFIG> encoder;
+    CHECK(encoder);
+    CHECK(encoder.position() == 0);
+}
+
+int main(void)
+{
+    esp_event_loop_create_default();
+    _test_encoder();
+    if (_failures != 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", _failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
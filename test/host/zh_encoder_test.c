@@ -0,0 +1,1259 @@
+#include "zh_encoder.h"
+#include "quadrature.h"
+#include "host.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define A_GPIO GPIO_NUM_4
+#define B_GPIO GPIO_NUM_16
+#define S_GPIO GPIO_NUM_17
+#define Z_GPIO GPIO_NUM_21
+#define GESTURE_CAPTURE_SIZE 16
+
+#define CHECK(cond)                                                              \
+    if (!(cond))                                                                 \
+    {                                                                            \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        ++_failures;                                                             \
+        goto cleanup;                                                            \
+    }
+
+#define WAIT_FOR(cond, timeout_ms)                                                                                        \
+    for (int64_t _deadline = esp_timer_get_time() + (timeout_ms) * 1000LL; !(cond) && esp_timer_get_time() < _deadline;)  \
+    {                                                                                                                     \
+        vTaskDelay(1);                                                                                                    \
+    }
+
+typedef struct
+{
+    volatile uint32_t encoder_event_count;
+    volatile float encoder_position;
+    volatile int64_t encoder_time;
+    volatile uint32_t button_event_count;
+    volatile bool button_status;
+    volatile int64_t button_time;
+    volatile uint32_t index_event_count;
+    zh_encoder_index_event_t index_event;
+    volatile uint32_t gesture_event_count;
+    zh_encoder_button_gesture_event_t gesture_event[GESTURE_CAPTURE_SIZE];
+    int64_t gesture_time[GESTURE_CAPTURE_SIZE];
+    volatile uint32_t batch_event_count;
+    zh_encoder_batch_event_on_isr_t batch_event;
+} event_capture_t;
+
+typedef struct
+{
+    TaskHandle_t isr_task;
+    volatile int64_t isr_ticks;
+    volatile int32_t isr_delta_sum;
+    volatile uint32_t isr_count;
+    volatile float position;
+    volatile float delta_sum;
+    volatile uint32_t count;
+    volatile bool is_task_context;
+} callback_capture_t;
+
+static int _failures = 0;
+static event_capture_t _capture = {0};
+
+static void _event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data)
+{
+    (void)event_base;
+    event_capture_t *capture = arg;
+    if (event_id == ZH_ENCODER_EVENT)
+    {
+        capture->encoder_position = ((zh_encoder_event_on_isr_t *)event_data)->encoder_position;
+        capture->encoder_time = esp_timer_get_time();
+        __atomic_fetch_add(&capture->encoder_event_count, 1, __ATOMIC_RELEASE);
+    }
+    else if (event_id == ZH_BUTTON_EVENT)
+    {
+        capture->button_status = ((zh_encoder_button_event_on_isr_t *)event_data)->button_status;
+        capture->button_time = esp_timer_get_time();
+        __atomic_fetch_add(&capture->button_event_count, 1, __ATOMIC_RELEASE);
+    }
+    else if (event_id == ZH_INDEX_EVENT)
+    {
+        capture->index_event = *(zh_encoder_index_event_t *)event_data;
+        __atomic_fetch_add(&capture->index_event_count, 1, __ATOMIC_RELEASE);
+    }
+    else if (event_id == ZH_BUTTON_GESTURE_EVENT && capture->gesture_event_count < GESTURE_CAPTURE_SIZE)
+    {
+        capture->gesture_event[capture->gesture_event_count] = *(zh_encoder_button_gesture_event_t *)event_data;
+        capture->gesture_time[capture->gesture_event_count] = esp_timer_get_time();
+        __atomic_fetch_add(&capture->gesture_event_count, 1, __ATOMIC_RELEASE);
+    }
+    else if (event_id == ZH_ENCODER_BATCH_EVENT)
+    {
+        capture->batch_event = *(zh_encoder_batch_event_on_isr_t *)event_data;
+        __atomic_fetch_add(&capture->batch_event_count, 1, __ATOMIC_RELEASE);
+    }
+}
+
+static int64_t _ticks_get(const zh_encoder_handle_t *handle)
+{
+    int64_t ticks = 0;
+    zh_encoder_get_ticks(handle, &ticks);
+    return ticks;
+}
+
+static void _test_steps(zh_encoder_backend_t backend)
+{
+    zh_encoder_handle_t handle = {0};
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.encoder_number = 1;
+    config.backend = backend;
+    _capture = (event_capture_t){0};
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    quadrature_t quadrature = {0};
+    quadrature_init(&quadrature, A_GPIO, B_GPIO);
+    quadrature_cycles(&quadrature, 5);
+    WAIT_FOR(_ticks_get(&handle) == 5, 1000);
+    CHECK(_ticks_get(&handle) == 5);
+    quadrature_cycles(&quadrature, -3);
+    WAIT_FOR(_ticks_get(&handle) == 2 && _capture.encoder_position == 2, 1000);
+    CHECK(_ticks_get(&handle) == 2);
+    CHECK(_capture.encoder_position == 2);
+    CHECK(_capture.encoder_event_count > 0);
+    quadrature_cycles(&quadrature, 20);
+    WAIT_FOR(_ticks_get(&handle) == 10, 1000);
+    CHECK(_ticks_get(&handle) == 10);
+cleanup:
+    zh_encoder_deinit(&handle);
+}
+
+static void _test_button_debounce_latency(void)
+{
+    zh_encoder_handle_t handle = {0};
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.s_gpio_number = S_GPIO;
+    config.s_gpio_debounce_time = 2000;
+    config.encoder_number = 1;
+    _capture = (event_capture_t){0};
+    host_gpio_set_level(S_GPIO, 1);
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    int64_t latency_max = 0;
+    for (uint8_t i = 0; i < 10; ++i)
+    {
+        bool level = (i % 2 != 0);
+        vTaskDelay(1);
+        quadrature_button(S_GPIO, level, 0, 0);
+        int64_t edge_time = esp_timer_get_time();
+        WAIT_FOR(_capture.button_event_count == i + 1U, 1000);
+        CHECK(_capture.button_event_count == i + 1U);
+        CHECK(_capture.button_status == level);
+        if (_capture.button_time - edge_time > latency_max)
+        {
+            latency_max = _capture.button_time - edge_time;
+        }
+    }
+    CHECK(latency_max < 2000 + 1000000 / configTICK_RATE_HZ / 2);
+cleanup:
+    zh_encoder_deinit(&handle);
+}
+
+static void _test_button_gestures(void)
+{
+    zh_encoder_handle_t handle = {0};
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.s_gpio_number = S_GPIO;
+    config.s_gpio_debounce_time = 1000;
+    config.encoder_number = 1;
+    config.button_gestures = true;
+    config.button_long_press_time = 100;
+    config.button_double_click_time = 50;
+    config.button_repeat_period = 30;
+    _capture = (event_capture_t){0};
+    host_gpio_set_level(S_GPIO, 1);
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    quadrature_button(S_GPIO, 0, 3, 100);
+    vTaskDelay(pdMS_TO_TICKS(10));
+    int64_t release_time = esp_timer_get_time();
+    quadrature_button(S_GPIO, 1, 3, 100);
+    WAIT_FOR(_capture.gesture_event_count == 1, 1000);
+    CHECK(_capture.gesture_event_count == 1);
+    CHECK(_capture.gesture_event[0].gesture == ZH_ENCODER_GESTURE_CLICK);
+    CHECK(_capture.gesture_time[0] - release_time >= 50000);
+    CHECK(_capture.gesture_time[0] - release_time < 50000 + 20000);
+    for (uint8_t i = 0; i < 2; ++i)
+    {
+        quadrature_button(S_GPIO, 0, 0, 0);
+        vTaskDelay(pdMS_TO_TICKS(10));
+        quadrature_button(S_GPIO, 1, 0, 0);
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    WAIT_FOR(_capture.gesture_event_count == 2, 1000);
+    vTaskDelay(pdMS_TO_TICKS(100));
+    CHECK(_capture.gesture_event_count == 2);
+    CHECK(_capture.gesture_event[1].gesture == ZH_ENCODER_GESTURE_DOUBLE_CLICK);
+    int64_t press_time = esp_timer_get_time();
+    quadrature_button(S_GPIO, 0, 0, 0);
+    WAIT_FOR(_capture.gesture_event_count == 6, 1000);
+    quadrature_button(S_GPIO, 1, 0, 0);
+    vTaskDelay(pdMS_TO_TICKS(20));
+    uint32_t gesture_event_count = _capture.gesture_event_count;
+    vTaskDelay(pdMS_TO_TICKS(100));
+    CHECK(_capture.gesture_event_count == gesture_event_count);
+    CHECK(_capture.gesture_event[2].gesture == ZH_ENCODER_GESTURE_LONG_PRESS);
+    CHECK(_capture.gesture_time[2] - press_time >= 100000);
+    CHECK(_capture.gesture_time[2] - press_time < 100000 + 20000);
+    for (uint8_t i = 3; i < 6; ++i)
+    {
+        CHECK(_capture.gesture_event[i].gesture == ZH_ENCODER_GESTURE_REPEAT);
+        CHECK(_capture.gesture_event[i].repeat_count == i - 2);
+        CHECK(_capture.gesture_time[i] - _capture.gesture_time[i - 1] > 30000 - 10000);
+        CHECK(_capture.gesture_time[i] - _capture.gesture_time[i - 1] < 30000 + 10000);
+    }
+cleanup:
+    host_gpio_set_level(S_GPIO, 1);
+    zh_encoder_deinit(&handle);
+}
+
+static float _stored_position_get(const char *key)
+{
+    uint32_t value = 0;
+    float position = NAN;
+    if (host_nvs_get_u32("zh_encoder", key, &value) == true)
+    {
+        memcpy(&position, &value, sizeof(position));
+    }
+    return position;
+}
+
+static void _test_persistence(void)
+{
+    zh_encoder_handle_t handle = {0};
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.encoder_number = 3;
+    config.encoder_min_value = -100;
+    config.encoder_max_value = 100;
+    config.persistence = true;
+    config.persistence_quiet_period = 20;
+    host_nvs_erase();
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    quadrature_t quadrature = {0};
+    quadrature_init(&quadrature, A_GPIO, B_GPIO);
+    quadrature_cycles(&quadrature, 7);
+    WAIT_FOR(_stored_position_get("position_3") == 7, 1000);
+    CHECK(_stored_position_get("position_3") == 7);
+    uint32_t set_count = host_nvs_set_count();
+    quadrature_cycles(&quadrature, 2);
+    WAIT_FOR(_ticks_get(&handle) == 9, 1000);
+    CHECK(zh_encoder_deinit(&handle) == ESP_OK);
+    CHECK(host_nvs_set_count() == set_count + 1);
+    CHECK(_stored_position_get("position_3") == 9);
+    host_nvs_power_cycle();
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    float position = 0;
+    CHECK(zh_encoder_get(&handle, &position) == ESP_OK);
+    CHECK(position == 9);
+    set_count = host_nvs_set_count();
+    CHECK(zh_encoder_deinit(&handle) == ESP_OK);
+    CHECK(host_nvs_set_count() == set_count);
+    return;
+cleanup:
+    zh_encoder_deinit(&handle);
+}
+
+static void _test_trace_replay(void)
+{
+    zh_encoder_handle_t handle = {0};
+    zh_encoder_trace_record_t *old_buffer = malloc(4 * sizeof(zh_encoder_trace_record_t));
+    zh_encoder_trace_record_t buffer[32] = {0};
+    zh_encoder_trace_record_t records[32] = {0};
+    uint16_t quantity = 0;
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.s_gpio_number = S_GPIO;
+    config.s_gpio_debounce_time = 1000;
+    config.encoder_number = 1;
+    host_gpio_set_level(S_GPIO, 1);
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    quadrature_t quadrature = {0};
+    quadrature_init(&quadrature, A_GPIO, B_GPIO);
+    CHECK(zh_encoder_trace_start(old_buffer, 4) == ESP_OK);
+    quadrature_cycles(&quadrature, 2);
+    CHECK(zh_encoder_trace_start(buffer, 32) == ESP_OK);
+    free(old_buffer);
+    old_buffer = NULL;
+    quadrature_cycles(&quadrature, 5);
+    quadrature_cycles(&quadrature, -2);
+    quadrature_button(S_GPIO, 0, 0, 0);
+    vTaskDelay(pdMS_TO_TICKS(20));
+    quadrature_button(S_GPIO, 1, 0, 0);
+    zh_encoder_trace_freeze();
+    CHECK(zh_encoder_trace_export(records, 32, &quantity) == ESP_OK);
+    CHECK(quantity == 9);
+    CHECK(records[7].type == ZH_ENCODER_TRACE_BUTTON && records[7].value == 0);
+    CHECK(records[8].type == ZH_ENCODER_TRACE_BUTTON && records[8].value == 1);
+    WAIT_FOR(_ticks_get(&handle) == 5, 1000);
+    CHECK(zh_encoder_deinit(&handle) == ESP_OK);
+    config.backend = ZH_ENCODER_BACKEND_REPLAY;
+    config.a_gpio_number = GPIO_NUM_MAX;
+    config.b_gpio_number = GPIO_NUM_MAX;
+    _capture = (event_capture_t){0};
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    quadrature_cycles(&quadrature, 3);
+    quadrature_button(S_GPIO, 0, 0, 0);
+    CHECK(zh_encoder_trace_replay(records, quantity) == ESP_OK);
+    WAIT_FOR(_ticks_get(&handle) == 3 && _capture.button_event_count == 2, 1000);
+    CHECK(_ticks_get(&handle) == 3);
+    CHECK(_capture.button_event_count == 2);
+    CHECK(_capture.button_status == true);
+cleanup:
+    free(old_buffer);
+    host_gpio_set_level(S_GPIO, 1);
+    zh_encoder_deinit(&handle);
+}
+
+static uint32_t _histogram_sum(const uint32_t *histogram)
+{
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < ZH_ENCODER_LATENCY_BUCKETS; ++i)
+    {
+        sum += histogram[i];
+    }
+    return sum;
+}
+
+static void _test_hysteresis(void)
+{
+    zh_encoder_handle_t handle = {0};
+    zh_encoder_metrics_t metrics = {0};
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.encoder_number = 1;
+    config.hysteresis_count = 3;
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    quadrature_t quadrature = {0};
+    quadrature_init(&quadrature, A_GPIO, B_GPIO);
+    quadrature_cycles(&quadrature, 5);
+    quadrature_cycles(&quadrature, -1);
+    quadrature_cycles(&quadrature, 1);
+    quadrature_cycles(&quadrature, -2);
+    vTaskDelay(pdMS_TO_TICKS(20));
+    CHECK(_ticks_get(&handle) == 5);
+    CHECK(zh_encoder_get_metrics(&handle, &metrics) == ESP_OK);
+    CHECK(metrics.step_reject_count == 2);
+    CHECK(metrics.step_count == 5);
+    quadrature_cycles(&quadrature, -1);
+    WAIT_FOR(_ticks_get(&handle) == 2, 1000);
+    CHECK(_ticks_get(&handle) == 2);
+    CHECK(zh_encoder_deinit(&handle) == ESP_OK);
+    config.hysteresis_count = 0;
+    config.hysteresis_window = 50;
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    quadrature_cycles(&quadrature, 3);
+    quadrature_cycles(&quadrature, -1);
+    quadrature_cycles(&quadrature, 1);
+    quadrature_cycles(&quadrature, -1);
+    vTaskDelay(pdMS_TO_TICKS(20));
+    CHECK(_ticks_get(&handle) == 3);
+    CHECK(zh_encoder_get_metrics(&handle, &metrics) == ESP_OK);
+    CHECK(metrics.step_reject_count == 2);
+    vTaskDelay(pdMS_TO_TICKS(50));
+    quadrature_cycles(&quadrature, -1);
+    WAIT_FOR(_ticks_get(&handle) == 1, 1000);
+    CHECK(_ticks_get(&handle) == 1);
+    quadrature_cycles(&quadrature, -1);
+    WAIT_FOR(_ticks_get(&handle) == 0, 1000);
+    CHECK(_ticks_get(&handle) == 0);
+cleanup:
+    zh_encoder_deinit(&handle);
+}
+
+static bool _event_interval_run(bool event_coalescing, int64_t *first_time)
+{
+    bool result = false;
+    zh_encoder_handle_t handle = {0};
+    zh_encoder_metrics_t metrics = {0};
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.encoder_number = 1;
+    config.event_min_interval = 100;
+    config.event_coalescing = event_coalescing;
+    _capture = (event_capture_t){0};
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    quadrature_t quadrature = {0};
+    quadrature_init(&quadrature, A_GPIO, B_GPIO);
+    quadrature_cycles(&quadrature, 1);
+    WAIT_FOR(_capture.encoder_event_count == 1, 1000);
+    CHECK(_capture.encoder_event_count == 1);
+    *first_time = _capture.encoder_time;
+    for (uint8_t i = 0; i < 3; ++i)
+    {
+        vTaskDelay(pdMS_TO_TICKS(10));
+        quadrature_cycles(&quadrature, 1);
+    }
+    vTaskDelay(pdMS_TO_TICKS(200));
+    CHECK(zh_encoder_get_metrics(&handle, &metrics) == ESP_OK);
+    CHECK(metrics.event_skip_count >= 1);
+    result = true;
+cleanup:
+    zh_encoder_deinit(&handle);
+    return result;
+}
+
+static void _test_event_interval(void)
+{
+    int64_t first_time = 0;
+    CHECK(_event_interval_run(false, &first_time) == true);
+    CHECK(_capture.encoder_event_count == 1);
+    CHECK(_capture.encoder_position == 1);
+    CHECK(_event_interval_run(true, &first_time) == true);
+    CHECK(_capture.encoder_event_count == 2);
+    CHECK(_capture.encoder_position == 4);
+    CHECK(_capture.encoder_time - first_time >= 100000);
+    CHECK(_capture.encoder_time - first_time < 100000 + 30000);
+cleanup:
+    return;
+}
+
+static float _velocity_get(const zh_encoder_handle_t *handle)
+{
+    float velocity = 0;
+    zh_encoder_get_velocity(handle, &velocity);
+    return velocity;
+}
+
+static void _test_velocity(void)
+{
+    zh_encoder_handle_t handle = {0};
+    float velocity = 0;
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.encoder_number = 1;
+    config.encoder_step = 0.5;
+    config.encoder_min_value = -100;
+    config.encoder_max_value = 100;
+    CHECK(zh_encoder_get_velocity(&handle, &velocity) == ESP_FAIL);
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    CHECK(zh_encoder_get_velocity(&handle, NULL) == ESP_ERR_INVALID_ARG);
+    CHECK(_velocity_get(&handle) == 0);
+    quadrature_t quadrature = {0};
+    quadrature_init(&quadrature, A_GPIO, B_GPIO);
+    for (uint8_t i = 0; i < 10; ++i)
+    {
+        quadrature_cycles(&quadrature, 1);
+        vTaskDelay(pdMS_TO_TICKS(20));
+    }
+    quadrature_cycles(&quadrature, 1);
+    WAIT_FOR(_ticks_get(&handle) == 11, 1000);
+    velocity = _velocity_get(&handle);
+    CHECK(velocity > 25 * 0.6 && velocity < 25 * 1.4);
+    for (uint8_t i = 0; i < 10; ++i)
+    {
+        quadrature_cycles(&quadrature, -1);
+        vTaskDelay(pdMS_TO_TICKS(20));
+    }
+    quadrature_cycles(&quadrature, -1);
+    WAIT_FOR(_ticks_get(&handle) == 0, 1000);
+    velocity = _velocity_get(&handle);
+    CHECK(velocity < -25 * 0.6 && velocity > -25 * 1.4);
+    vTaskDelay(pdMS_TO_TICKS(500));
+    velocity = _velocity_get(&handle);
+    CHECK(velocity <= 0 && velocity >= -1.0f);
+cleanup:
+    zh_encoder_deinit(&handle);
+}
+
+static void _test_metrics(void)
+{
+    zh_encoder_handle_t handle = {0};
+    zh_encoder_metrics_t metrics = {0};
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.encoder_number = 1;
+    _capture = (event_capture_t){0};
+    CHECK(zh_encoder_get_metrics(&handle, &metrics) == ESP_FAIL);
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    CHECK(zh_encoder_get_metrics(&handle, NULL) == ESP_ERR_INVALID_ARG);
+    CHECK(zh_encoder_get_metrics(&handle, &metrics) == ESP_OK);
+    CHECK(metrics.step_count == 0 && metrics.event_post_count == 0);
+    quadrature_t quadrature = {0};
+    quadrature_init(&quadrature, A_GPIO, B_GPIO);
+    quadrature_cycles(&quadrature, 5);
+    WAIT_FOR(_capture.encoder_position == 5, 1000);
+    vTaskDelay(pdMS_TO_TICKS(20));
+    quadrature_cycles(&quadrature, -2);
+    WAIT_FOR(_capture.encoder_position == 3, 1000);
+    vTaskDelay(pdMS_TO_TICKS(20));
+    CHECK(zh_encoder_get_metrics(&handle, &metrics) == ESP_OK);
+    CHECK(metrics.step_count == 7);
+    CHECK(metrics.step_drop_count == 0);
+    CHECK(metrics.step_reject_count == 0);
+    CHECK(metrics.event_post_count == _capture.encoder_event_count);
+    CHECK(metrics.event_post_count >= 2);
+    CHECK(metrics.event_post_error == 0);
+    CHECK(metrics.pending_steps_max >= 1 && metrics.pending_steps_max <= 5);
+    CHECK(_histogram_sum(metrics.process_latency) >= 2);
+    CHECK(_histogram_sum(metrics.post_latency) == metrics.event_post_count);
+cleanup:
+    zh_encoder_deinit(&handle);
+}
+
+static void _test_acceleration(void)
+{
+    zh_encoder_handle_t handle = {0};
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.encoder_number = 1;
+    config.encoder_min_value = -1000;
+    config.encoder_max_value = 1000;
+    config.acceleration[0] = (zh_encoder_acceleration_t){.step_rate = 30, .multiplier = 2};
+    config.acceleration[1] = (zh_encoder_acceleration_t){.step_rate = 1000, .multiplier = 4};
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    quadrature_t quadrature = {0};
+    quadrature_init(&quadrature, A_GPIO, B_GPIO);
+    for (uint8_t i = 0; i < 3; ++i)
+    {
+        quadrature_cycles(&quadrature, 1);
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+    CHECK(_ticks_get(&handle) == 3);
+    for (uint8_t i = 0; i < 5; ++i)
+    {
+        quadrature_cycles(&quadrature, 1);
+        vTaskDelay(pdMS_TO_TICKS(20));
+    }
+    WAIT_FOR(_ticks_get(&handle) == 3 + 1 + 4 * 2, 1000);
+    CHECK(_ticks_get(&handle) == 3 + 1 + 4 * 2);
+    quadrature_cycles(&quadrature, 40);
+    vTaskDelay(pdMS_TO_TICKS(50));
+    int64_t ticks = _ticks_get(&handle);
+    CHECK(ticks >= 12 + 40 * 2 && ticks <= 12 + 40 * 4);
+    quadrature_cycles(&quadrature, -1);
+    WAIT_FOR(_ticks_get(&handle) == ticks - 1, 1000);
+    CHECK(_ticks_get(&handle) == ticks - 1);
+cleanup:
+    zh_encoder_deinit(&handle);
+}
+
+static void _test_init_many(void)
+{
+    zh_encoder_init_config_t config[2] = {ZH_ENCODER_INIT_CONFIG_DEFAULT(), ZH_ENCODER_INIT_CONFIG_DEFAULT()};
+    zh_encoder_handle_t handle[2] = {0};
+    config[0].a_gpio_number = A_GPIO;
+    config[0].b_gpio_number = B_GPIO;
+    config[0].encoder_number = 1;
+    config[1].a_gpio_number = GPIO_NUM_18;
+    config[1].b_gpio_number = GPIO_NUM_19;
+    config[1].encoder_number = 2;
+    config[1].task_priority = config[0].task_priority + 1;
+    CHECK(zh_encoder_init_many(config, handle, 2) != ESP_OK);
+    CHECK(handle[0].is_initialized == false && handle[1].is_initialized == false);
+    config[1].task_priority = config[0].task_priority;
+    config[0].batch_mode = true;
+    config[0].batch_frame_period = 10;
+    config[1].batch_mode = true;
+    config[1].batch_frame_period = 50;
+    CHECK(zh_encoder_init_many(config, handle, 2) != ESP_OK);
+    CHECK(handle[0].is_initialized == false && handle[1].is_initialized == false);
+    config[0].batch_mode = false;
+    config[1].batch_mode = false;
+    CHECK(zh_encoder_init_many(config, handle, 2) == ESP_OK);
+    quadrature_t quadrature = {0};
+    quadrature_init(&quadrature, GPIO_NUM_18, GPIO_NUM_19);
+    quadrature_cycles(&quadrature, 4);
+    WAIT_FOR(_ticks_get(&handle[1]) == 4, 1000);
+    CHECK(_ticks_get(&handle[1]) == 4);
+    CHECK(_ticks_get(&handle[0]) == 0);
+cleanup:
+    zh_encoder_deinit(&handle[0]);
+    zh_encoder_deinit(&handle[1]);
+}
+
+static void _test_batch(void)
+{
+    zh_encoder_init_config_t config[2] = {ZH_ENCODER_INIT_CONFIG_DEFAULT(), ZH_ENCODER_INIT_CONFIG_DEFAULT()};
+    zh_encoder_handle_t handle[2] = {0};
+    config[0].a_gpio_number = A_GPIO;
+    config[0].b_gpio_number = B_GPIO;
+    config[0].encoder_number = 1;
+    config[0].batch_mode = true;
+    config[0].batch_frame_period = 50;
+    config[1] = config[0];
+    config[1].a_gpio_number = GPIO_NUM_18;
+    config[1].b_gpio_number = GPIO_NUM_19;
+    config[1].encoder_number = 2;
+    _capture = (event_capture_t){0};
+    CHECK(zh_encoder_init_many(config, handle, 2) == ESP_OK);
+    quadrature_t quadrature[2] = {0};
+    quadrature_init(&quadrature[0], A_GPIO, B_GPIO);
+    quadrature_init(&quadrature[1], GPIO_NUM_18, GPIO_NUM_19);
+    int64_t start_time = esp_timer_get_time();
+    quadrature_cycles(&quadrature[0], 3);
+    quadrature_cycles(&quadrature[1], -2);
+    WAIT_FOR(_capture.batch_event_count == 1, 1000);
+    CHECK(_capture.batch_event_count == 1);
+    CHECK(esp_timer_get_time() - start_time >= 50000);
+    CHECK(_capture.batch_event.encoder_quantity == 2);
+    for (uint8_t i = 0; i < 2; ++i)
+    {
+        const zh_encoder_batch_item_t *item = &_capture.batch_event.encoder_data[i];
+        CHECK(item->encoder_number == 1 || item->encoder_number == 2);
+        CHECK(item->encoder_position == ((item->encoder_number == 1) ? 3 : -2));
+        CHECK(item->encoder_delta == item->encoder_position);
+        CHECK(item->step_count == ((item->encoder_number == 1) ? 3U : 2U));
+    }
+    quadrature_cycles(&quadrature[0], -1);
+    WAIT_FOR(_capture.batch_event_count == 2, 1000);
+    CHECK(_capture.batch_event_count == 2);
+    CHECK(_capture.batch_event.encoder_quantity == 1);
+    CHECK(_capture.batch_event.encoder_data[0].encoder_number == 1);
+    CHECK(_capture.batch_event.encoder_data[0].encoder_position == 2);
+    CHECK(_capture.batch_event.encoder_data[0].encoder_delta == -1);
+    CHECK(_capture.encoder_event_count == 0);
+cleanup:
+    zh_encoder_deinit(&handle[0]);
+    zh_encoder_deinit(&handle[1]);
+}
+
+static void _test_reinit_profile(void)
+{
+    zh_encoder_handle_t handle = {0};
+    zh_encoder_profile_t profile = {0};
+    float position = 0;
+    float value = 0;
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.encoder_number = 1;
+    config.encoder_min_value = -100;
+    config.encoder_max_value = 100;
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    quadrature_t quadrature = {0};
+    quadrature_init(&quadrature, A_GPIO, B_GPIO);
+    quadrature_cycles(&quadrature, 30);
+    WAIT_FOR(_ticks_get(&handle) == 30, 1000);
+    CHECK(zh_encoder_reinit_mode(&handle, 0, 10, 2, ZH_ENCODER_REINIT_REMAP) == ESP_OK);
+    CHECK(zh_encoder_get(&handle, &position) == ESP_OK && position == 6);
+    quadrature_cycles(&quadrature, 1);
+    WAIT_FOR(_ticks_get(&handle) == 1, 1000);
+    CHECK(zh_encoder_get(&handle, &position) == ESP_OK && position == 8);
+    CHECK(zh_encoder_reinit_mode(&handle, -5, 5, 1, ZH_ENCODER_REINIT_CLAMP) == ESP_OK);
+    CHECK(zh_encoder_get(&handle, &position) == ESP_OK && position == 5);
+    quadrature_cycles(&quadrature, -2);
+    WAIT_FOR(_ticks_get(&handle) == -2, 1000);
+    CHECK(zh_encoder_get(&handle, &position) == ESP_OK && position == 3);
+    CHECK(zh_encoder_reinit_mode(&handle, -50, 50, 1, (zh_encoder_reinit_mode_t)99) == ESP_ERR_INVALID_ARG);
+    CHECK(zh_encoder_get(&handle, &position) == ESP_OK && position == 3);
+    zh_encoder_init_config_t profile_config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    profile_config.encoder_min_value = 0;
+    profile_config.encoder_max_value = 100;
+    profile_config.encoder_step = 5;
+    profile_config.mapping = ZH_ENCODER_MAPPING_TABLE;
+    profile_config.mapping_table[0] = (zh_encoder_mapping_point_t){0, 0};
+    profile_config.mapping_table[1] = (zh_encoder_mapping_point_t){100, 1};
+    profile_config.mapping_table_size = 2;
+    profile_config.encoder_max_value = -1;
+    CHECK(zh_encoder_profile_init(&profile_config, &profile) == ESP_ERR_INVALID_ARG);
+    profile_config.encoder_max_value = 100;
+    CHECK(zh_encoder_profile_init(&profile_config, &profile) == ESP_OK);
+    CHECK(zh_encoder_set_profile(&handle, &profile, ZH_ENCODER_REINIT_REMAP) == ESP_OK);
+    CHECK(zh_encoder_get(&handle, &position) == ESP_OK && position == 80);
+    CHECK(zh_encoder_get_value(&handle, &value) == ESP_OK && fabsf(value - 0.8f) < 1e-6f);
+    quadrature_cycles(&quadrature, 1);
+    WAIT_FOR(_ticks_get(&handle) == 1, 1000);
+    CHECK(zh_encoder_get(&handle, &position) == ESP_OK && position == 85);
+    CHECK(zh_encoder_set_profile(&handle, NULL, ZH_ENCODER_REINIT_REMAP) == ESP_OK);
+    CHECK(zh_encoder_get(&handle, &position) == ESP_OK && position == 70);
+    CHECK(zh_encoder_get_value(&handle, &value) == ESP_OK && value == 70);
+cleanup:
+    zh_encoder_deinit(&handle);
+}
+
+static float _position_get(const zh_encoder_handle_t *handle)
+{
+    float position = 0;
+    zh_encoder_get(handle, &position);
+    return position;
+}
+
+static void _test_wrap_around(void)
+{
+    zh_encoder_handle_t handle = {0};
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.encoder_number = 1;
+    config.encoder_min_value = 0;
+    config.encoder_max_value = 10;
+    config.wrap_around = true;
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    quadrature_t quadrature = {0};
+    quadrature_init(&quadrature, A_GPIO, B_GPIO);
+    quadrature_cycles(&quadrature, 5);
+    WAIT_FOR(_position_get(&handle) == 10, 1000);
+    CHECK(_position_get(&handle) == 10);
+    quadrature_cycles(&quadrature, 1);
+    WAIT_FOR(_position_get(&handle) == 0, 1000);
+    CHECK(_position_get(&handle) == 0);
+    quadrature_cycles(&quadrature, -1);
+    WAIT_FOR(_position_get(&handle) == 10, 1000);
+    CHECK(_position_get(&handle) == 10);
+    quadrature_cycles(&quadrature, 3 * 11 + 2);
+    WAIT_FOR(_position_get(&handle) == 1, 1000);
+    CHECK(_position_get(&handle) == 1);
+    quadrature_cycles(&quadrature, -(2 * 11 + 2));
+    WAIT_FOR(_position_get(&handle) == 10, 1000);
+    CHECK(_position_get(&handle) == 10);
+cleanup:
+    zh_encoder_deinit(&handle);
+}
+
+static bool _mapping_check(zh_encoder_handle_t *handle, float position, float expected_value, float tolerance)
+{
+    float value = NAN;
+    zh_encoder_snapshot_t snapshot = {0};
+    if (zh_encoder_set(handle, position) != ESP_OK || zh_encoder_get_value(handle, &value) != ESP_OK || zh_encoder_get_snapshot(handle, &snapshot) != ESP_OK)
+    {
+        return false;
+    }
+    return fabsf(value - expected_value) <= tolerance && snapshot.encoder_value == value;
+}
+
+static void _test_mapping(void)
+{
+    zh_encoder_handle_t handle = {0};
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.encoder_number = 1;
+    config.encoder_min_value = 0;
+    config.encoder_max_value = 100;
+    config.mapping = ZH_ENCODER_MAPPING_LOG;
+    config.mapping_min_value = 0;
+    config.mapping_max_value = 1;
+    config.mapping_curvature = 4;
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    CHECK(_mapping_check(&handle, 0, 0, 1e-6f) == true);
+    CHECK(_mapping_check(&handle, 50, logf(3) / logf(5), 1e-5f) == true);
+    CHECK(_mapping_check(&handle, 30, log1pf(1.2f) / logf(5), 1e-2f) == true);
+    CHECK(_mapping_check(&handle, 100, 1, 1e-6f) == true);
+    CHECK(zh_encoder_deinit(&handle) == ESP_OK);
+    config.mapping = ZH_ENCODER_MAPPING_EXP;
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    CHECK(_mapping_check(&handle, 0, 0, 1e-6f) == true);
+    CHECK(_mapping_check(&handle, 50, expm1f(2) / expm1f(4), 1e-5f) == true);
+    CHECK(_mapping_check(&handle, 30, expm1f(1.2f) / expm1f(4), 1e-2f) == true);
+    CHECK(_mapping_check(&handle, 100, 1, 1e-6f) == true);
+    CHECK(zh_encoder_deinit(&handle) == ESP_OK);
+    config.encoder_min_value = -10;
+    config.encoder_max_value = 10;
+    config.encoder_step = 0.5;
+    config.mapping = ZH_ENCODER_MAPPING_TABLE;
+    config.mapping_table[0] = (zh_encoder_mapping_point_t){-5, 0};
+    config.mapping_table[1] = (zh_encoder_mapping_point_t){0, 2};
+    config.mapping_table[2] = (zh_encoder_mapping_point_t){5, 10};
+    config.mapping_table_size = 3;
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    CHECK(_mapping_check(&handle, -10, 0, 0) == true);
+    CHECK(_mapping_check(&handle, -5, 0, 0) == true);
+    CHECK(_mapping_check(&handle, -2.5, 1, 1e-6f) == true);
+    CHECK(_mapping_check(&handle, 0, 2, 1e-6f) == true);
+    CHECK(_mapping_check(&handle, 2.5, 6, 1e-6f) == true);
+    CHECK(_mapping_check(&handle, 10, 10, 0) == true);
+cleanup:
+    zh_encoder_deinit(&handle);
+}
+
+static void _wait_setter_task(void *pvParameter)
+{
+    vTaskDelay(pdMS_TO_TICKS(20));
+    zh_encoder_set((zh_encoder_handle_t *)pvParameter, 4);
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+static void _wait_stepper_task(void *pvParameter)
+{
+    (void)pvParameter;
+    quadrature_t quadrature = {0};
+    quadrature_init(&quadrature, A_GPIO, B_GPIO);
+    vTaskDelay(pdMS_TO_TICKS(20));
+    quadrature_cycles(&quadrature, 3);
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+static void _test_snapshot_all(void)
+{
+    zh_encoder_handle_t handle[2] = {0};
+    zh_encoder_snapshot_t snapshots[3] = {0};
+    uint8_t quantity = UINT8_MAX;
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    CHECK(zh_encoder_get_snapshot_all(NULL, 3, &quantity) == ESP_ERR_INVALID_ARG);
+    CHECK(zh_encoder_get_snapshot_all(snapshots, 3, &quantity) == ESP_OK && quantity == 0);
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.encoder_number = 3;
+    CHECK(zh_encoder_init(&config, &handle[0]) == ESP_OK);
+    config.a_gpio_number = GPIO_NUM_18;
+    config.b_gpio_number = GPIO_NUM_19;
+    config.encoder_number = 7;
+    CHECK(zh_encoder_init(&config, &handle[1]) == ESP_OK);
+    CHECK(zh_encoder_set(&handle[1], -6) == ESP_OK);
+    quadrature_t quadrature = {0};
+    quadrature_init(&quadrature, A_GPIO, B_GPIO);
+    quadrature_cycles(&quadrature, -4);
+    WAIT_FOR(_ticks_get(&handle[0]) == -4, 1000);
+    CHECK(zh_encoder_get_snapshot_all(snapshots, 3, &quantity) == ESP_OK);
+    CHECK(quantity == 2);
+    for (uint8_t i = 0; i < quantity; ++i)
+    {
+        if (snapshots[i].encoder_number == 3)
+        {
+            CHECK(snapshots[i].encoder_position == -4 && snapshots[i].encoder_ticks == -4);
+            CHECK(snapshots[i].direction == -1 && snapshots[i].step_time != 0);
+        }
+        else
+        {
+            CHECK(snapshots[i].encoder_number == 7);
+            CHECK(snapshots[i].encoder_position == -6 && snapshots[i].encoder_ticks == 0);
+            CHECK(snapshots[i].direction == 0 && snapshots[i].step_time == 0);
+        }
+    }
+    CHECK(snapshots[0].encoder_number != snapshots[1].encoder_number);
+    CHECK(zh_encoder_get_snapshot_all(snapshots, 1, &quantity) == ESP_OK && quantity == 1);
+cleanup:
+    zh_encoder_deinit(&handle[0]);
+    zh_encoder_deinit(&handle[1]);
+}
+
+static void _test_wait(void)
+{
+    zh_encoder_handle_t handle[2] = {0};
+    zh_encoder_handle_t *const handles[2] = {&handle[0], &handle[1]};
+    zh_encoder_snapshot_t snapshots[2] = {0};
+    uint32_t changed = UINT32_MAX;
+    TaskHandle_t setter_task = NULL;
+    TaskHandle_t stepper_task = NULL;
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.encoder_number = 1;
+    CHECK(zh_encoder_init(&config, &handle[0]) == ESP_OK);
+    config.a_gpio_number = GPIO_NUM_18;
+    config.b_gpio_number = GPIO_NUM_19;
+    config.encoder_number = 2;
+    CHECK(zh_encoder_init(&config, &handle[1]) == ESP_OK);
+    CHECK(zh_encoder_wait(handles, 0, 0, snapshots, &changed) == ESP_ERR_INVALID_ARG);
+    int64_t start_time = esp_timer_get_time();
+    CHECK(zh_encoder_wait(handles, 2, pdMS_TO_TICKS(30), snapshots, &changed) == ESP_ERR_TIMEOUT);
+    CHECK(esp_timer_get_time() - start_time >= 20000);
+    CHECK(changed == 0);
+    CHECK(snapshots[0].encoder_number == 1 && snapshots[1].encoder_number == 2);
+    CHECK(xTaskCreatePinnedToCore(&_wait_setter_task, "wait_setter", configMINIMAL_STACK_SIZE, &handle[1], 1, &setter_task, tskNO_AFFINITY) == pdPASS);
+    CHECK(zh_encoder_wait(handles, 2, pdMS_TO_TICKS(1000), snapshots, &changed) == ESP_OK);
+    CHECK(changed == 2);
+    CHECK(snapshots[1].encoder_position == 4 && snapshots[0].encoder_position == 0);
+    CHECK(xTaskCreatePinnedToCore(&_wait_stepper_task, "wait_stepper", configMINIMAL_STACK_SIZE, NULL, 1, &stepper_task, tskNO_AFFINITY) == pdPASS);
+    CHECK(zh_encoder_wait(&handles[0], 1, pdMS_TO_TICKS(1000), snapshots, NULL) == ESP_OK);
+    CHECK(snapshots[0].encoder_ticks > 0);
+cleanup:
+    if (setter_task != NULL)
+    {
+        vTaskDelete(setter_task);
+    }
+    if (stepper_task != NULL)
+    {
+        vTaskDelete(stepper_task);
+    }
+    zh_encoder_deinit(&handle[0]);
+    zh_encoder_deinit(&handle[1]);
+}
+
+static void _test_task_groups(void)
+{
+    zh_encoder_handle_t handle[3] = {0};
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.encoder_number = 1;
+    CHECK(zh_encoder_init(&config, &handle[0]) == ESP_OK);
+    config.a_gpio_number = GPIO_NUM_18;
+    config.b_gpio_number = GPIO_NUM_19;
+    config.encoder_number = 2;
+    config.task_group = ZH_ENCODER_MAX_TASK_GROUPS;
+    CHECK(zh_encoder_init(&config, &handle[1]) != ESP_OK);
+    config.task_group = 1;
+    config.task_priority = 2;
+    CHECK(zh_encoder_init(&config, &handle[1]) == ESP_OK);
+    CHECK(handle[1].task_handle != NULL && handle[1].task_handle != handle[0].task_handle);
+    config.a_gpio_number = GPIO_NUM_22;
+    config.b_gpio_number = GPIO_NUM_23;
+    config.encoder_number = 3;
+    config.task_priority = 3;
+    CHECK(zh_encoder_init(&config, &handle[2]) != ESP_OK);
+    config.task_priority = 2;
+    CHECK(zh_encoder_init(&config, &handle[2]) == ESP_OK);
+    CHECK(handle[2].task_handle == handle[1].task_handle);
+    quadrature_t quadrature[3] = {0};
+    quadrature_init(&quadrature[0], A_GPIO, B_GPIO);
+    quadrature_init(&quadrature[1], GPIO_NUM_18, GPIO_NUM_19);
+    quadrature_init(&quadrature[2], GPIO_NUM_22, GPIO_NUM_23);
+    quadrature_cycles(&quadrature[0], 2);
+    quadrature_cycles(&quadrature[1], 3);
+    quadrature_cycles(&quadrature[2], -4);
+    WAIT_FOR(_position_get(&handle[0]) == 2 && _position_get(&handle[1]) == 3 && _position_get(&handle[2]) == -4, 1000);
+    CHECK(_position_get(&handle[0]) == 2 && _position_get(&handle[1]) == 3 && _position_get(&handle[2]) == -4);
+    CHECK(zh_encoder_deinit(&handle[1]) == ESP_OK);
+    CHECK(zh_encoder_deinit(&handle[2]) == ESP_OK);
+    quadrature_cycles(&quadrature[0], 1);
+    WAIT_FOR(_position_get(&handle[0]) == 3, 1000);
+    CHECK(_position_get(&handle[0]) == 3);
+    config.task_priority = 3;
+    CHECK(zh_encoder_init(&config, &handle[2]) == ESP_OK);
+    quadrature_cycles(&quadrature[2], 1);
+    WAIT_FOR(_position_get(&handle[2]) == 1, 1000);
+    CHECK(_position_get(&handle[2]) == 1);
+cleanup:
+    zh_encoder_deinit(&handle[0]);
+    zh_encoder_deinit(&handle[1]);
+    zh_encoder_deinit(&handle[2]);
+}
+
+static void _index_pulse(void)
+{
+    host_gpio_set_level(Z_GPIO, 1);
+    host_gpio_set_level(Z_GPIO, 0);
+}
+
+static void _test_index(void)
+{
+    zh_encoder_handle_t handle = {0};
+    zh_encoder_index_event_t index = {0};
+    float position = 0;
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.z_gpio_number = Z_GPIO;
+    config.encoder_number = 1;
+    config.encoder_min_value = -100;
+    config.encoder_max_value = 100;
+    config.index_position = 10;
+    _capture = (event_capture_t){0};
+    host_gpio_set_level(Z_GPIO, 0);
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    quadrature_t quadrature = {0};
+    quadrature_init(&quadrature, A_GPIO, B_GPIO);
+    quadrature_cycles(&quadrature, 5);
+    _index_pulse();
+    WAIT_FOR(_capture.index_event_count == 1, 1000);
+    CHECK(_capture.index_event_count == 1);
+    CHECK(_capture.index_event.encoder_position == 5);
+    CHECK(_capture.index_event.position_error == -5);
+    CHECK(_capture.index_event.is_corrected == false && _capture.index_event.is_homed == false);
+    CHECK(zh_encoder_get(&handle, &position) == ESP_OK && position == 5);
+    CHECK(zh_encoder_home(&handle) == ESP_OK);
+    quadrature_cycles(&quadrature, 3);
+    _index_pulse();
+    WAIT_FOR(_capture.index_event_count == 2, 1000);
+    CHECK(_capture.index_event_count == 2);
+    CHECK(_capture.index_event.encoder_position == 8);
+    CHECK(_capture.index_event.position_error == -2);
+    CHECK(_capture.index_event.is_corrected == true && _capture.index_event.is_homed == true);
+    CHECK(zh_encoder_get(&handle, &position) == ESP_OK && position == 10);
+    quadrature_cycles(&quadrature, 4);
+    _index_pulse();
+    WAIT_FOR(_capture.index_event_count == 3, 1000);
+    CHECK(_capture.index_event_count == 3);
+    CHECK(_capture.index_event.position_error == 4);
+    CHECK(_capture.index_event.is_corrected == false && _capture.index_event.is_homed == true);
+    CHECK(zh_encoder_get(&handle, &position) == ESP_OK && position == 14);
+    CHECK(zh_encoder_get_index(&handle, &index) == ESP_OK);
+    CHECK(index.index_count == 3 && index.encoder_position == 14 && index.position_error == 4);
+    CHECK(zh_encoder_deinit(&handle) == ESP_OK);
+    config.index_mode = ZH_ENCODER_INDEX_RESET;
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    quadrature_cycles(&quadrature, -7);
+    _index_pulse();
+    WAIT_FOR(_capture.index_event_count == 4, 1000);
+    CHECK(_capture.index_event_count == 4);
+    CHECK(_capture.index_event.position_error == -17);
+    CHECK(_capture.index_event.is_corrected == true && _capture.index_event.is_homed == true);
+    CHECK(zh_encoder_get(&handle, &position) == ESP_OK && position == 10);
+    quadrature_cycles(&quadrature, 2);
+    _index_pulse();
+    WAIT_FOR(_capture.index_event_count == 5, 1000);
+    CHECK(_capture.index_event.position_error == 2);
+    CHECK(zh_encoder_get(&handle, &position) == ESP_OK && position == 10);
+cleanup:
+    zh_encoder_deinit(&handle);
+}
+
+static void _isr_callback(uint8_t encoder_number, int64_t ticks, int32_t delta, void *arg)
+{
+    (void)encoder_number;
+    callback_capture_t *capture = arg;
+    capture->isr_ticks = ticks;
+    capture->isr_delta_sum += delta;
+    __atomic_fetch_add(&capture->isr_count, 1, __ATOMIC_RELEASE);
+}
+
+static void _callback(uint8_t encoder_number, float position, float delta, void *arg)
+{
+    (void)encoder_number;
+    callback_capture_t *capture = arg;
+    capture->position = position;
+    capture->delta_sum += delta;
+    capture->is_task_context = (xTaskGetCurrentTaskHandle() != capture->isr_task);
+    __atomic_fetch_add(&capture->count, 1, __ATOMIC_RELEASE);
+}
+
+static void _test_callbacks(void)
+{
+    zh_encoder_handle_t handle = {0};
+    callback_capture_t capture = {0};
+    capture.isr_task = xTaskGetCurrentTaskHandle();
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.encoder_number = 1;
+    config.encoder_step = 0.5;
+    config.callback = &_callback;
+    config.isr_callback = &_isr_callback;
+    config.callback_arg = &capture;
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    quadrature_t quadrature = {0};
+    quadrature_init(&quadrature, A_GPIO, B_GPIO);
+    quadrature_cycles(&quadrature, 6);
+    CHECK(capture.isr_count == 6);
+    CHECK(capture.isr_ticks == 6);
+    quadrature_cycles(&quadrature, -2);
+    CHECK(capture.isr_count == 8);
+    CHECK(capture.isr_ticks == 4);
+    CHECK(capture.isr_delta_sum == 4);
+    WAIT_FOR(capture.position == 2, 1000);
+    CHECK(capture.position == 2);
+    CHECK(capture.delta_sum == 2);
+    CHECK(capture.is_task_context == true);
+    config.counter_mode = true;
+    CHECK(zh_encoder_init(&config, &(zh_encoder_handle_t){0}) != ESP_OK);
+cleanup:
+    zh_encoder_deinit(&handle);
+}
+
+static void _test_pcnt_steps(void)
+{
+    _test_steps(ZH_ENCODER_BACKEND_PCNT);
+}
+
+static void _test_software_steps(void)
+{
+    _test_steps(ZH_ENCODER_BACKEND_SOFTWARE);
+}
+
+static bool _direction_run(zh_encoder_backend_t backend, zh_encoder_resolution_t resolution, const int *cycles, uint8_t quantity, int8_t *direction, int64_t *ticks)
+{
+    bool is_done = false;
+    zh_encoder_handle_t handle = {0};
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.encoder_number = 1;
+    config.encoder_min_value = -1000;
+    config.encoder_max_value = 1000;
+    config.backend = backend;
+    config.resolution = resolution;
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    quadrature_t quadrature = {0};
+    quadrature_init(&quadrature, A_GPIO, B_GPIO);
+    int64_t expected_ticks = 0;
+    for (uint8_t i = 0; i < quantity; ++i)
+    {
+        expected_ticks += cycles[i] * ((resolution == ZH_ENCODER_RESOLUTION_X4) ? 4 : (resolution == ZH_ENCODER_RESOLUTION_X2) ? 2 : 1);
+        quadrature_cycles(&quadrature, cycles[i]);
+        WAIT_FOR(_ticks_get(&handle) == expected_ticks, 1000);
+        zh_encoder_snapshot_t snapshot = {0};
+        CHECK(zh_encoder_get_snapshot(&handle, &snapshot) == ESP_OK);
+        direction[i] = snapshot.direction;
+        ticks[i] = snapshot.encoder_ticks;
+    }
+    is_done = true;
+cleanup:
+    zh_encoder_deinit(&handle);
+    return is_done;
+}
+
+static void _test_backend_direction(void)
+{
+    static const int cycles[] = {3, -2, 1, -5, 4};
+    static const zh_encoder_resolution_t resolution[] = {ZH_ENCODER_RESOLUTION_X1, ZH_ENCODER_RESOLUTION_X2, ZH_ENCODER_RESOLUTION_X4};
+    const uint8_t quantity = sizeof(cycles) / sizeof(cycles[0]);
+    for (uint8_t r = 0; r < sizeof(resolution) / sizeof(resolution[0]); ++r)
+    {
+        int8_t pcnt_direction[sizeof(cycles) / sizeof(cycles[0])] = {0};
+        int8_t software_direction[sizeof(cycles) / sizeof(cycles[0])] = {0};
+        int64_t pcnt_ticks[sizeof(cycles) / sizeof(cycles[0])] = {0};
+        int64_t software_ticks[sizeof(cycles) / sizeof(cycles[0])] = {0};
+        CHECK(_direction_run(ZH_ENCODER_BACKEND_PCNT, resolution[r], cycles, quantity, pcnt_direction, pcnt_ticks) == true);
+        CHECK(_direction_run(ZH_ENCODER_BACKEND_SOFTWARE, resolution[r], cycles, quantity, software_direction, software_ticks) == true);
+        for (uint8_t i = 0; i < quantity; ++i)
+        {
+            CHECK(pcnt_direction[i] == ((cycles[i] > 0) ? 1 : -1));
+            CHECK(software_direction[i] == pcnt_direction[i]);
+            CHECK(software_ticks[i] == pcnt_ticks[i]);
+        }
+    }
+cleanup:
+    return;
+}
+
+static void _test_counter_overflow(void)
+{
+    zh_encoder_handle_t handle = {0};
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.encoder_number = 1;
+    config.encoder_min_value = -10000;
+    config.encoder_max_value = 10000;
+    config.counter_mode = true;
+    config.counter_event_period = 10;
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    quadrature_t quadrature = {0};
+    quadrature_init(&quadrature, A_GPIO, B_GPIO);
+    quadrature_cycles(&quadrature, 2500);
+    WAIT_FOR(_ticks_get(&handle) == 2500, 1000);
+    CHECK(_ticks_get(&handle) == 2500);
+    quadrature_cycles(&quadrature, -4200);
+    WAIT_FOR(_ticks_get(&handle) == -1700, 1000);
+    CHECK(_ticks_get(&handle) == -1700);
+cleanup:
+    zh_encoder_deinit(&handle);
+}
+
+static void _test_button(void)
+{
+    zh_encoder_handle_t handle = {0};
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.s_gpio_number = S_GPIO;
+    config.s_gpio_debounce_time = 5000;
+    config.encoder_number = 1;
+    _capture = (event_capture_t){0};
+    host_gpio_set_level(S_GPIO, 1);
+    CHECK(zh_encoder_init(&config, &handle) == ESP_OK);
+    quadrature_button(S_GPIO, 0, 5, 100);
+    WAIT_FOR(_capture.button_event_count == 1, 1000);
+    CHECK(_capture.button_event_count == 1);
+    CHECK(_capture.button_status == false);
+    quadrature_button(S_GPIO, 1, 5, 100);
+    WAIT_FOR(_capture.button_event_count == 2, 1000);
+    CHECK(_capture.button_event_count == 2);
+    CHECK(_capture.button_status == true);
+cleanup:
+    zh_encoder_deinit(&handle);
+}
+
+static void _test_event_loop(void)
+{
+    zh_encoder_handle_t handle[2] = {0};
+    event_capture_t loop_capture = {0};
+    esp_event_loop_handle_t event_loop = NULL;
+    esp_event_handler_instance_t instance = NULL;
+    esp_event_loop_args_t event_loop_args = {.queue_size = 8, .task_name = "zh_encoder_test", .task_priority = 1, .task_stack_size = 4096, .task_core_id = tskNO_AFFINITY};
+    CHECK(esp_event_loop_create(&event_loop_args, &event_loop) == ESP_OK);
+    CHECK(esp_event_handler_instance_register_with(event_loop, ZH_ENCODER, ESP_EVENT_ANY_ID, &_event_handler, &loop_capture, &instance) == ESP_OK);
+    zh_encoder_init_config_t config = ZH_ENCODER_INIT_CONFIG_DEFAULT();
+    config.a_gpio_number = A_GPIO;
+    config.b_gpio_number = B_GPIO;
+    config.s_gpio_number = S_GPIO;
+    config.encoder_number = 1;
+    config.event_loop = event_loop;
+    _capture = (event_capture_t){0};
+    host_gpio_set_level(S_GPIO, 1);
+    CHECK(zh_encoder_init(&config, &handle[0]) == ESP_OK);
+    config.a_gpio_number = GPIO_NUM_18;
+    config.b_gpio_number = GPIO_NUM_19;
+    config.s_gpio_number = GPIO_NUM_MAX;
+    config.encoder_number = 2;
+    config.event_loop = NULL;
+    CHECK(zh_encoder_init(&config, &handle[1]) == ESP_OK);
+    quadrature_t quadrature[2] = {0};
+    quadrature_init(&quadrature[0], A_GPIO, B_GPIO);
+    quadrature_init(&quadrature[1], GPIO_NUM_18, GPIO_NUM_19);
+    quadrature_cycles(&quadrature[0], 3);
+    quadrature_button(S_GPIO, 0, 0, 0);
+    WAIT_FOR(loop_capture.encoder_position == 3 && loop_capture.button_event_count == 1, 1000);
+    CHECK(loop_capture.encoder_position == 3);
+    CHECK(loop_capture.button_event_count == 1 && loop_capture.button_status == false);
+    CHECK(_capture.encoder_event_count == 0 && _capture.button_event_count == 0);
+    quadrature_cycles(&quadrature[1], -2);
+    WAIT_FOR(_capture.encoder_position == -2, 1000);
+    CHECK(_capture.encoder_position == -2);
+    vTaskDelay(pdMS_TO_TICKS(20));
+    CHECK(loop_capture.encoder_position == 3);
+cleanup:
+    host_gpio_set_level(S_GPIO, 1);
+    zh_encoder_deinit(&handle[0]);
+    zh_encoder_deinit(&handle[1]);
+    if (event_loop != NULL)
+    {
+        esp_event_handler_instance_unregister_with(event_loop, ZH_ENCODER, ESP_EVENT_ANY_ID, instance);
+        esp_event_loop_delete(event_loop);
+    }
+}
+
+int main(void)
+{
+    esp_event_loop_create_default();
+    esp_event_handler_instance_t instance = NULL;
+    esp_event_handler_instance_register(ZH_ENCODER, ESP_EVENT_ANY_ID, &_event_handler, &_capture, &instance);
+    _test_pcnt_steps();
+    _test_software_steps();
+    _test_backend_direction();
+    _test_counter_overflow();
+    _test_button();
+    _test_button_debounce_latency();
+    _test_button_gestures();
+    _test_callbacks();
+    _test_persistence();
+    _test_trace_replay();
+    _test_metrics();
+    _test_acceleration();
+    _test_event_interval();
+    _test_hysteresis();
+    _test_velocity();
+    _test_init_many();
+    _test_batch();
+    _test_reinit_profile();
+    _test_snapshot_all();
+    _test_wait();
+    _test_wrap_around();
+    _test_mapping();
+    _test_index();
+    _test_task_groups();
+    _test_event_loop();
+    esp_event_handler_instance_unregister(ZH_ENCODER, ESP_EVENT_ANY_ID, instance);
+    if (_failures != 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", _failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
@@ -1,8 +1,15 @@
 #include "zh_encoder.h"
+#include <string.h>
+#include <math.h>
+#include <stdio.h>
 
 #define TAG "zh_encoder"
 
+#ifdef CONFIG_ZH_ENCODER_QUIET_API
+#define ZH_LOGI(msg, ...)
+#else
 #define ZH_LOGI(msg, ...) ESP_LOGI(TAG, msg, ##__VA_ARGS__)
+#endif
 #define ZH_LOGE(msg, err, ...) ESP_LOGE(TAG, "[%s:%d:%s] " msg, __FILE__, __LINE__, esp_err_to_name(err), ##__VA_ARGS__)
 
 #define ZH_ERROR_CHECK(cond, err, cleanup, msg, ...) \
@@ -15,29 +22,134 @@
 
 #define ZH_ENCODER_DIRECTION_CW 1
 #define ZH_ENCODER_DIRECTION_CCW -1
+#define ZH_ENCODER_EVENT_RETRY_PERIOD 10
+#define ZH_ENCODER_SOFTWARE_STEP_TRANSITIONS 4
+#define ZH_ENCODER_NVS_NAMESPACE "zh_encoder"
+
+#ifdef CONFIG_ZH_ENCODER_ISR_IN_IRAM
+#define ZH_ENCODER_ISR_ATTR IRAM_ATTR
+#else
+#define ZH_ENCODER_ISR_ATTR
+#endif
+
+#ifdef CONFIG_ZH_ENCODER_TASK_IN_IRAM
+#define ZH_ENCODER_TASK_ATTR IRAM_ATTR
+#else
+#define ZH_ENCODER_TASK_ATTR
+#endif
+
+typedef enum
+{
+    ZH_ENCODER_BUTTON_STATE_IDLE,
+    ZH_ENCODER_BUTTON_STATE_PRESSED,
+    ZH_ENCODER_BUTTON_STATE_HOLD,
+    ZH_ENCODER_BUTTON_STATE_RELEASED,
+    ZH_ENCODER_BUTTON_STATE_SECOND_PRESSED
+} zh_encoder_button_state_t;
 
 typedef struct
 {
-    int watch_point_value;
-    zh_encoder_handle_t *handle;
-} zh_encoder_queue_t;
+    TaskHandle_t task_handle;
+    uint32_t slot_mask;
+    volatile uint32_t changed_mask;
+} zh_encoder_waiter_t;
+
+typedef struct
+{
+    TaskHandle_t task_handle;
+    esp_timer_handle_t deadline_timer;
+    volatile uint32_t pass_sequence;
+    uint8_t encoder_counter;
+    uint8_t task_priority;
+    uint16_t stack_size;
+    uint8_t queue_size;
+    int8_t task_core;
+} zh_encoder_task_group_t;
 
 TaskHandle_t zh_encoder = NULL;
-static QueueHandle_t _queue_handle = NULL;
 static portMUX_TYPE _spinlock = portMUX_INITIALIZER_UNLOCKED;
 
-volatile static uint8_t _encoder_counter = 0;
+static volatile uint8_t _encoder_counter = 0;
 static zh_encoder_stats_t _stats = {0};
-volatile static uint8_t _encoder_number_matrix[8] = {0};
+static uint32_t _encoder_number_bitmap[8] = {0};
+static uint32_t _encoder_slot_bitmap = 0;
+static zh_encoder_handle_t *volatile _encoder_handle_matrix[ZH_ENCODER_MAX_QUANTITY] = {NULL};
+static zh_encoder_task_group_t _task_group[ZH_ENCODER_MAX_TASK_GROUPS] = {0};
+static nvs_handle_t _nvs_handle = 0;
+static uint8_t _persistence_counter = 0;
+static zh_encoder_trace_record_t *_trace_buffer = NULL;
+static uint16_t _trace_size = 0;
+static volatile uint32_t _trace_head = 0;
+static volatile bool _trace_enabled = false;
+static DRAM_ATTR const int8_t _transition_table[16] = {0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0};
+static volatile uint32_t _state_sequence = 0;
+static uint16_t _batch_frame_period = 0;
+static zh_encoder_waiter_t _waiter[ZH_ENCODER_MAX_WAITERS] = {0};
+static volatile uint32_t _waiter_slot_mask = 0;
+#ifdef CONFIG_ZH_ENCODER_STATIC_ALLOCATION
+static StaticTask_t _task_tcb[ZH_ENCODER_MAX_TASK_GROUPS] = {0};
+static StackType_t _task_stack[ZH_ENCODER_MAX_TASK_GROUPS][CONFIG_ZH_ENCODER_STATIC_STACK_SIZE] = {0};
+#endif
 
 static esp_err_t _zh_encoder_validate_config(const zh_encoder_init_config_t *config, zh_encoder_handle_t *handle);
+static esp_err_t _zh_encoder_init_one(const zh_encoder_init_config_t *config, zh_encoder_handle_t *handle);
 static esp_err_t _zh_encoder_pcnt_init(const zh_encoder_init_config_t *config, zh_encoder_handle_t *handle);
+static esp_err_t _zh_encoder_software_init(const zh_encoder_init_config_t *config, zh_encoder_handle_t *handle);
+static esp_err_t _zh_encoder_decoder_init(const zh_encoder_init_config_t *config, zh_encoder_handle_t *handle);
 static esp_err_t _zh_encoder_gpio_init(const zh_encoder_init_config_t *config, zh_encoder_handle_t *handle);
-static esp_err_t _zh_encoder_resources_init(const zh_encoder_init_config_t *config);
-static esp_err_t _zh_encoder_task_init(const zh_encoder_init_config_t *config);
+static esp_err_t _zh_encoder_task_init(const zh_encoder_init_config_t *config, zh_encoder_handle_t *handle);
+static void _zh_encoder_task_deinit(zh_encoder_handle_t *handle);
+static void _zh_encoder_task_sync(const zh_encoder_handle_t *handle);
+static esp_err_t _zh_encoder_counter_init(const zh_encoder_init_config_t *config, zh_encoder_handle_t *handle);
+static bool _zh_encoder_position_update(zh_encoder_handle_t *handle, int steps, int64_t step_time, int64_t *prev_ticks, int64_t *ticks);
+static int64_t _zh_encoder_ticks_get(const zh_encoder_handle_t *handle);
+static void _zh_encoder_origin_set(zh_encoder_handle_t *handle, double origin);
+static void _zh_encoder_state_write_begin(void);
+static void _zh_encoder_state_write_end(void);
+static void _zh_encoder_snapshot_read(const zh_encoder_handle_t *handle, int count, zh_encoder_snapshot_t *snapshot);
+static int _zh_encoder_snapshot_count(const zh_encoder_handle_t *handle);
+static void _zh_encoder_snapshot_get(const zh_encoder_handle_t *handle, zh_encoder_snapshot_t *snapshot);
+static float _zh_encoder_position_calc(double origin, float step, float min, float max, int64_t ticks);
+static float _zh_encoder_ticks_to_position(const zh_encoder_handle_t *handle, int64_t ticks);
+static int64_t _zh_encoder_ticks_limit(const zh_encoder_handle_t *handle, int64_t ticks);
+static esp_err_t _zh_encoder_profile_validate(const zh_encoder_init_config_t *config);
+static void _zh_encoder_profile_build(const zh_encoder_init_config_t *config, zh_encoder_profile_t *profile);
+static void _zh_encoder_range_set(zh_encoder_handle_t *handle, float min, float max, float step, zh_encoder_reinit_mode_t mode, int steps);
+static float _zh_encoder_mapping_calc(const zh_encoder_handle_t *handle, float position);
+static int _zh_encoder_counter_steps(zh_encoder_handle_t *handle);
+static int _zh_encoder_acceleration(zh_encoder_handle_t *handle, int steps, uint32_t step_time);
+static void _zh_encoder_velocity_update(zh_encoder_handle_t *handle, int steps, uint32_t step_time);
+static float _zh_encoder_velocity_get(const zh_encoder_handle_t *handle, int64_t current_time);
+static void _zh_encoder_batch_post(uint8_t task_group);
+static int64_t _zh_encoder_event_post(zh_encoder_handle_t *handle);
+static esp_err_t _zh_encoder_event_send(esp_event_loop_handle_t event_loop, int32_t event_id, const void *event_data, size_t event_data_size, uint16_t event_timeout);
+static int64_t _zh_encoder_button_process(zh_encoder_handle_t *handle);
+static void _zh_encoder_gesture_process(zh_encoder_handle_t *handle, bool is_pressed, int64_t current_time);
+static void _zh_encoder_gesture_post(zh_encoder_handle_t *handle, zh_encoder_button_gesture_t gesture);
+static void _zh_encoder_metrics_begin(zh_encoder_handle_t *handle);
+static void _zh_encoder_metrics_end(zh_encoder_handle_t *handle);
+static uint8_t _zh_encoder_latency_bucket(uint32_t latency);
 static bool _zh_encoder_isr_handler(pcnt_unit_handle_t unit, const pcnt_watch_event_data_t *edata, void *user_ctx);
+static bool _zh_encoder_counter_isr_handler(pcnt_unit_handle_t unit, const pcnt_watch_event_data_t *edata, void *user_ctx);
+static bool _zh_encoder_step_isr(zh_encoder_handle_t *handle, int steps);
+static bool _zh_encoder_step_apply(zh_encoder_handle_t *handle, int steps, uint32_t current_time);
+static void _zh_encoder_trace_write(uint32_t time, uint8_t encoder_number, zh_encoder_trace_type_t type, int16_t value);
+static int _zh_encoder_hysteresis(zh_encoder_handle_t *handle, int steps, uint32_t step_time);
+static esp_err_t _zh_encoder_persistence_init(const zh_encoder_init_config_t *config, zh_encoder_handle_t *handle);
+static int64_t _zh_encoder_persistence_process(zh_encoder_handle_t *handle, bool *is_commit_required);
+static bool _zh_encoder_persistence_write(zh_encoder_handle_t *handle);
+static void _zh_encoder_persistence_request(zh_encoder_handle_t *handle);
+static void _zh_encoder_waiter_notify(const zh_encoder_handle_t *handle);
+static void _zh_encoder_waiter_mask_update(void);
 static void _zh_encoder_isr_processing_task(void *pvParameter);
+static void _zh_encoder_process(zh_encoder_handle_t *handle, int64_t *batch_frame_end);
 static void _zh_encoder_button_isr_handler(void *arg);
+static void _zh_encoder_software_isr_handler(void *arg);
+static void _zh_encoder_index_isr_handler(void *arg);
+static void _zh_encoder_index_latch(zh_encoder_handle_t *handle);
+static void _zh_encoder_index_process(zh_encoder_handle_t *handle);
+static void _zh_encoder_counter_timer_handler(void *arg);
+static void _zh_encoder_deadline_timer_handler(void *arg);
 
 ESP_EVENT_DEFINE_BASE(ZH_ENCODER);
 
@@ -46,37 +158,53 @@ esp_err_t zh_encoder_init(const zh_encoder_init_config_t *config, zh_encoder_han
     ZH_LOGI("Encoder initialization started.");
     ZH_ERROR_CHECK(config != NULL && handle != NULL, ESP_ERR_INVALID_ARG, NULL, "Encoder initialization failed. Invalid argument.");
     ZH_ERROR_CHECK(handle->is_initialized == false, ESP_ERR_INVALID_STATE, NULL, "Encoder initialization failed. Encoder is already initialized.");
-    ZH_ERROR_CHECK(_encoder_counter < sizeof(_encoder_number_matrix), ESP_ERR_INVALID_ARG, NULL, "Encoder initialization failed. Maximum quantity reached.");
+    ZH_ERROR_CHECK(_encoder_counter < ZH_ENCODER_MAX_QUANTITY, ESP_ERR_INVALID_ARG, NULL, "Encoder initialization failed. Maximum quantity reached.");
     ZH_ERROR_CHECK(_zh_encoder_validate_config(config, handle) == ESP_OK, ESP_FAIL, NULL, "Encoder initialization failed. Initial configuration check failed.");
-    ZH_ERROR_CHECK(_zh_encoder_resources_init(config) == ESP_OK, ESP_FAIL, NULL, "Encoder initialization failed. Resources initialization failed.");
-    ZH_ERROR_CHECK(_zh_encoder_task_init(config) == ESP_OK, ESP_FAIL,
-                   vQueueDelete(_queue_handle), "Encoder initialization failed. Processing task initialization failed.");
-    ZH_ERROR_CHECK(_zh_encoder_pcnt_init(config, handle) == ESP_OK, ESP_FAIL,
-                   vQueueDelete(_queue_handle);
-                   vTaskDelete(zh_encoder), "Encoder initialization failed. PCNT initialization failed.");
-    ZH_ERROR_CHECK(_zh_encoder_gpio_init(config, handle) == ESP_OK, ESP_FAIL,
-                   ZH_ERROR_CHECK(pcnt_unit_stop(handle->pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT unit stop fail.");
-                   ZH_ERROR_CHECK(pcnt_unit_disable(handle->pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT unit disable fail.");
-                   ZH_ERROR_CHECK(pcnt_del_channel(handle->pcnt_channel_a_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
-                   ZH_ERROR_CHECK(pcnt_del_channel(handle->pcnt_channel_b_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
-                   ZH_ERROR_CHECK(pcnt_del_unit(handle->pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete unit fail.");
-                   vQueueDelete(_queue_handle);
-                   vTaskDelete(zh_encoder), "Encoder initialization failed. GPIO initialization failed.");
-    if (_stats.min_stack_size == 0)
-    {
-        _stats.min_stack_size = config->stack_size;
-    }
-    handle->is_initialized = true;
-    ++_encoder_counter;
-    for (uint8_t i = 0; i < sizeof(_encoder_number_matrix); ++i)
+    ZH_ERROR_CHECK(_zh_encoder_init_one(config, handle) == ESP_OK, ESP_FAIL, NULL, "Encoder initialization failed.");
+    ZH_LOGI("Encoder initialization completed successfully.");
+    return ESP_OK;
+}
+
+esp_err_t zh_encoder_init_many(const zh_encoder_init_config_t *configs, zh_encoder_handle_t *handles, uint8_t quantity)
+{
+    ZH_LOGI("Encoder batch initialization started.");
+    ZH_ERROR_CHECK(configs != NULL && handles != NULL && quantity > 0, ESP_ERR_INVALID_ARG, NULL, "Encoder batch initialization failed. Invalid argument.");
+    ZH_ERROR_CHECK(_encoder_counter + quantity <= ZH_ENCODER_MAX_QUANTITY, ESP_ERR_INVALID_ARG, NULL, "Encoder batch initialization failed. Maximum quantity reached.");
+    uint32_t number_bitmap[8] = {0};
+    for (uint8_t i = 0; i < quantity; ++i)
     {
-        if (_encoder_number_matrix[i] == 0)
+        ZH_ERROR_CHECK(handles[i].is_initialized == false, ESP_ERR_INVALID_STATE, NULL, "Encoder batch initialization failed. Encoder is already initialized.");
+        uint8_t encoder_number = configs[i].encoder_number;
+        ZH_ERROR_CHECK((number_bitmap[encoder_number >> 5] & (1UL << (encoder_number & 31))) == 0, ESP_ERR_INVALID_ARG, NULL, "Encoder batch initialization failed. Encoder number is repeated.");
+        number_bitmap[encoder_number >> 5] |= 1UL << (encoder_number & 31);
+        ZH_ERROR_CHECK(_zh_encoder_validate_config(&configs[i], &handles[i]) == ESP_OK, ESP_ERR_INVALID_ARG, NULL, "Encoder batch initialization failed. Initial configuration check failed.");
+        for (uint8_t j = 0; j < i; ++j)
         {
-            _encoder_number_matrix[i] = handle->encoder_number;
-            break;
+            ZH_ERROR_CHECK(configs[j].batch_mode == false || configs[i].batch_mode == false || configs[j].batch_frame_period == configs[i].batch_frame_period, ESP_ERR_INVALID_ARG, NULL,
+                           "Encoder batch initialization failed. Batch frame period differs from other encoders.");
+            if (configs[j].task_group != configs[i].task_group)
+            {
+                continue;
+            }
+            ZH_ERROR_CHECK(configs[j].task_priority == configs[i].task_priority && configs[j].stack_size == configs[i].stack_size && configs[j].queue_size == configs[i].queue_size &&
+                               configs[j].task_core == configs[i].task_core,
+                           ESP_ERR_INVALID_ARG, NULL, "Encoder batch initialization failed. Task settings differ from other encoders in the task group.");
+            ZH_ERROR_CHECK(configs[j].batch_mode == false || configs[i].batch_mode == false || configs[j].event_loop == configs[i].event_loop, ESP_ERR_INVALID_ARG, NULL,
+                           "Encoder batch initialization failed. Event loop differs from other encoders in batch mode in the task group.");
         }
     }
-    ZH_LOGI("Encoder initialization completed successfully.");
+    esp_err_t err = gpio_install_isr_service(ESP_INTR_FLAG_LOWMED);
+    ZH_ERROR_CHECK(err == ESP_OK || err == ESP_ERR_INVALID_STATE, ESP_FAIL, NULL, "Encoder batch initialization failed. Failed install isr service.");
+    for (uint8_t i = 0; i < quantity; ++i)
+    {
+        err = _zh_encoder_init_one(&configs[i], &handles[i]);
+        ZH_ERROR_CHECK(err == ESP_OK, err,
+                       while (i-- > 0) {
+                           zh_encoder_deinit(&handles[i]);
+                       },
+                       "Encoder batch initialization failed. Encoder initialization failed.");
+    }
+    ZH_LOGI("Encoder batch initialization completed successfully.");
     return ESP_OK;
 }
 
@@ -85,74 +213,314 @@ esp_err_t zh_encoder_deinit(zh_encoder_handle_t *handle) // -V2008
     ZH_LOGI("Encoder deinitialization started.");
     ZH_ERROR_CHECK(handle != NULL, ESP_ERR_INVALID_ARG, NULL, "Encoder deinitialization failed. Invalid argument.");
     ZH_ERROR_CHECK(handle->is_initialized == true, ESP_FAIL, NULL, "Encoder deinitialization failed. Encoder not initialized.");
-    ZH_ERROR_CHECK(pcnt_unit_stop(handle->pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. PCNT unit stop fail.");
-    ZH_ERROR_CHECK(pcnt_unit_disable(handle->pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. PCNT unit disable fail.");
-    ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(handle->pcnt_unit_handle, ZH_ENCODER_DIRECTION_CW) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. PCNT unit remove watch point fail.");
-    ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(handle->pcnt_unit_handle, ZH_ENCODER_DIRECTION_CCW) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. PCNT unit remove watch point fail.");
-    ZH_ERROR_CHECK(pcnt_del_channel(handle->pcnt_channel_a_handle) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. PCNT delete channel fail.");
-    ZH_ERROR_CHECK(pcnt_del_channel(handle->pcnt_channel_b_handle) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. PCNT delete channel fail.");
-    ZH_ERROR_CHECK(pcnt_del_unit(handle->pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. PCNT delete unit fail.");
-    if (handle->s_gpio_number != GPIO_NUM_MAX)
+    if (handle->counter_mode == true)
+    {
+        esp_timer_stop(handle->counter_timer_handle);
+        ZH_ERROR_CHECK(esp_timer_delete(handle->counter_timer_handle) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. Timer delete fail.");
+    }
+    if (handle->backend == ZH_ENCODER_BACKEND_SOFTWARE)
+    {
+        ZH_ERROR_CHECK(gpio_isr_handler_remove((gpio_num_t)handle->a_gpio_number) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. Remove GPIO isr handler failed.");
+        ZH_ERROR_CHECK(gpio_isr_handler_remove((gpio_num_t)handle->b_gpio_number) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. Remove GPIO isr handler failed.");
+        ZH_ERROR_CHECK(gpio_reset_pin((gpio_num_t)handle->a_gpio_number) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. Reset GPIO failed.");
+        ZH_ERROR_CHECK(gpio_reset_pin((gpio_num_t)handle->b_gpio_number) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. Reset GPIO failed.");
+    }
+    else if (handle->backend == ZH_ENCODER_BACKEND_PCNT)
+    {
+        ZH_ERROR_CHECK(pcnt_unit_stop(handle->pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. PCNT unit stop fail.");
+        ZH_ERROR_CHECK(pcnt_unit_disable(handle->pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. PCNT unit disable fail.");
+        ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(handle->pcnt_unit_handle, handle->pcnt_high_watch_point) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. PCNT unit remove watch point fail.");
+        ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(handle->pcnt_unit_handle, handle->pcnt_low_watch_point) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. PCNT unit remove watch point fail.");
+        ZH_ERROR_CHECK(pcnt_del_channel(handle->pcnt_channel_a_handle) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. PCNT delete channel fail.");
+        ZH_ERROR_CHECK(pcnt_del_channel(handle->pcnt_channel_b_handle) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. PCNT delete channel fail.");
+        ZH_ERROR_CHECK(pcnt_del_unit(handle->pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. PCNT delete unit fail.");
+    }
+    if (handle->s_gpio_number != GPIO_NUM_MAX && handle->backend != ZH_ENCODER_BACKEND_REPLAY)
     {
         ZH_ERROR_CHECK(gpio_isr_handler_remove((gpio_num_t)handle->s_gpio_number) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. Remove GPIO isr handler failed.");
         ZH_ERROR_CHECK(gpio_reset_pin((gpio_num_t)handle->s_gpio_number) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. Reset GPIO failed.");
     }
-    if (_encoder_counter == 1)
+    if (handle->z_gpio_number != GPIO_NUM_MAX && handle->backend != ZH_ENCODER_BACKEND_REPLAY)
     {
-        vQueueDelete(_queue_handle);
-        vTaskDelete(zh_encoder);
+        ZH_ERROR_CHECK(gpio_isr_handler_remove((gpio_num_t)handle->z_gpio_number) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. Remove GPIO isr handler failed.");
+        ZH_ERROR_CHECK(gpio_reset_pin((gpio_num_t)handle->z_gpio_number) == ESP_OK, ESP_FAIL, NULL, "Encoder deinitialization failed. Reset GPIO failed.");
     }
     handle->is_initialized = false;
-    --_encoder_counter;
-    for (uint8_t i = 0; i < sizeof(_encoder_number_matrix); ++i)
+    bool is_nvs_close_required = false;
+    taskENTER_CRITICAL(&_spinlock);
+    if (--_encoder_counter == 0)
+    {
+        _batch_frame_period = 0;
+    }
+    if (handle->persistence == true && --_persistence_counter == 0)
+    {
+        is_nvs_close_required = true;
+    }
+    --_task_group[handle->task_group].encoder_counter;
+    _encoder_handle_matrix[handle->encoder_index] = NULL;
+    _encoder_slot_bitmap &= ~(1UL << handle->encoder_index);
+    _encoder_number_bitmap[handle->encoder_number >> 5] &= ~(1UL << (handle->encoder_number & 31));
+    taskEXIT_CRITICAL(&_spinlock);
+    _zh_encoder_task_sync(handle);
+    _zh_encoder_task_deinit(handle);
+    if (handle->persistence == true && (handle->persistence_dirty == true || __atomic_exchange_n(&handle->persistence_request, false, __ATOMIC_RELAXED) == true))
     {
-        if (_encoder_number_matrix[i] == handle->encoder_number)
+        handle->persistence_dirty = false;
+        if (_zh_encoder_persistence_write(handle) == true && nvs_commit(_nvs_handle) != ESP_OK)
         {
-            _encoder_number_matrix[i] = 0;
-            break;
+            ZH_LOGE("Encoder deinitialization failed. NVS commit failed.", ESP_FAIL);
         }
     }
+    if (is_nvs_close_required == true && _nvs_handle != 0)
+    {
+        nvs_close(_nvs_handle);
+        _nvs_handle = 0;
+    }
     ZH_LOGI("Encoder deinitialization completed successfully.");
     return ESP_OK;
 }
 
 esp_err_t zh_encoder_reinit(zh_encoder_handle_t *handle, float min, float max, float step) // -V2008
+{
+    return zh_encoder_reinit_mode(handle, min, max, step, ZH_ENCODER_REINIT_RESET);
+}
+
+esp_err_t zh_encoder_reinit_mode(zh_encoder_handle_t *handle, float min, float max, float step, zh_encoder_reinit_mode_t mode) // -V2008
 {
     ZH_LOGI("Encoder reinitialization started.");
     ZH_ERROR_CHECK(handle != NULL, ESP_ERR_INVALID_ARG, NULL, "Encoder reinitialization failed. Invalid argument.");
     ZH_ERROR_CHECK(handle->is_initialized == true, ESP_FAIL, NULL, "Encoder reinitialization failed. Encoder not initialized.");
     ZH_ERROR_CHECK(max > min, ESP_ERR_INVALID_ARG, NULL, "Encoder reinitialization failed. Invalid encoder min/max value.");
     ZH_ERROR_CHECK(step > 0, ESP_ERR_INVALID_ARG, NULL, "Encoder reinitialization failed. Invalid encoder step.");
+    ZH_ERROR_CHECK(mode == ZH_ENCODER_REINIT_RESET || mode == ZH_ENCODER_REINIT_REMAP || mode == ZH_ENCODER_REINIT_CLAMP, ESP_ERR_INVALID_ARG, NULL, "Encoder reinitialization failed. Invalid reinitialization mode.");
+    int steps = _zh_encoder_counter_steps(handle);
     taskENTER_CRITICAL(&_spinlock);
-    handle->encoder_min_value = min;
-    handle->encoder_max_value = max;
-    handle->encoder_step = step;
-    handle->encoder_position = (handle->encoder_min_value + handle->encoder_max_value) / 2;
+    _zh_encoder_state_write_begin();
+    _zh_encoder_range_set(handle, min, max, step, mode, steps);
+    _zh_encoder_state_write_end();
     taskEXIT_CRITICAL(&_spinlock);
+    _zh_encoder_persistence_request(handle);
+    _zh_encoder_waiter_notify(handle);
     ZH_LOGI("Encoder reinitialization completed successfully.");
     return ESP_OK;
 }
 
+esp_err_t zh_encoder_profile_init(const zh_encoder_init_config_t *config, zh_encoder_profile_t *profile)
+{
+    ZH_LOGI("Encoder profile initialization started.");
+    ZH_ERROR_CHECK(config != NULL && profile != NULL, ESP_ERR_INVALID_ARG, NULL, "Encoder profile initialization failed. Invalid argument.");
+    ZH_ERROR_CHECK(_zh_encoder_profile_validate(config) == ESP_OK, ESP_ERR_INVALID_ARG, NULL, "Encoder profile initialization failed. Initial configuration check failed.");
+    _zh_encoder_profile_build(config, profile);
+    ZH_LOGI("Encoder profile initialization completed successfully.");
+    return ESP_OK;
+}
+
+esp_err_t zh_encoder_set_profile(zh_encoder_handle_t *handle, const zh_encoder_profile_t *profile, zh_encoder_reinit_mode_t mode)
+{
+    ZH_LOGI("Encoder set profile started.");
+    ZH_ERROR_CHECK(handle != NULL, ESP_ERR_INVALID_ARG, NULL, "Encoder set profile failed. Invalid argument.");
+    ZH_ERROR_CHECK(handle->is_initialized == true, ESP_FAIL, NULL, "Encoder set profile failed. Encoder not initialized.");
+    ZH_ERROR_CHECK(mode == ZH_ENCODER_REINIT_RESET || mode == ZH_ENCODER_REINIT_REMAP || mode == ZH_ENCODER_REINIT_CLAMP, ESP_ERR_INVALID_ARG, NULL, "Encoder set profile failed. Invalid reinitialization mode.");
+    if (profile == NULL)
+    {
+        profile = &handle->profile;
+    }
+    int steps = _zh_encoder_counter_steps(handle);
+    taskENTER_CRITICAL(&_spinlock);
+    _zh_encoder_state_write_begin();
+    _zh_encoder_range_set(handle, profile->encoder_min_value, profile->encoder_max_value, profile->encoder_step, mode, steps);
+    handle->mapping_profile = profile;
+    _zh_encoder_state_write_end();
+    taskEXIT_CRITICAL(&_spinlock);
+    _zh_encoder_persistence_request(handle);
+    _zh_encoder_waiter_notify(handle);
+    ZH_LOGI("Encoder set profile completed successfully.");
+    return ESP_OK;
+}
+
 esp_err_t zh_encoder_set(zh_encoder_handle_t *handle, float position)
 {
     ZH_LOGI("Encoder set position started.");
     ZH_ERROR_CHECK(handle != NULL, ESP_ERR_INVALID_ARG, NULL, "Encoder set position failed. Invalid argument.");
     ZH_ERROR_CHECK(handle->is_initialized == true, ESP_FAIL, NULL, "Encoder set position failed. Encoder not initialized.");
     ZH_ERROR_CHECK(position <= handle->encoder_max_value && position >= handle->encoder_min_value, ESP_ERR_INVALID_ARG, NULL, "Encoder set position failed. Invalid argument.");
+    _zh_encoder_counter_steps(handle);
     taskENTER_CRITICAL(&_spinlock);
-    handle->encoder_position = position;
+    _zh_encoder_state_write_begin();
+    _zh_encoder_origin_set(handle, position);
+    _zh_encoder_state_write_end();
     taskEXIT_CRITICAL(&_spinlock);
+    _zh_encoder_persistence_request(handle);
+    _zh_encoder_waiter_notify(handle);
     ZH_LOGI("Encoder set position completed successfully.");
     return ESP_OK;
 }
 
 esp_err_t zh_encoder_get(const zh_encoder_handle_t *handle, float *position)
 {
-    ZH_LOGI("Encoder get position started.");
     ZH_ERROR_CHECK(handle != NULL && position != NULL, ESP_ERR_INVALID_ARG, NULL, "Encoder get position failed. Invalid argument.");
     ZH_ERROR_CHECK(handle->is_initialized == true, ESP_FAIL, NULL, "Encoder get position failed. Encoder not initialized.");
-    *position = handle->encoder_position;
-    ZH_LOGI("Encoder get position completed successfully.");
+    zh_encoder_snapshot_t snapshot = {0};
+    _zh_encoder_snapshot_get(handle, &snapshot);
+    *position = snapshot.encoder_position;
+    return ESP_OK;
+}
+
+esp_err_t zh_encoder_get_value(const zh_encoder_handle_t *handle, float *value)
+{
+    ZH_ERROR_CHECK(handle != NULL && value != NULL, ESP_ERR_INVALID_ARG, NULL, "Encoder get value failed. Invalid argument.");
+    ZH_ERROR_CHECK(handle->is_initialized == true, ESP_FAIL, NULL, "Encoder get value failed. Encoder not initialized.");
+    zh_encoder_snapshot_t snapshot = {0};
+    _zh_encoder_snapshot_get(handle, &snapshot);
+    *value = snapshot.encoder_value;
+    return ESP_OK;
+}
+
+esp_err_t zh_encoder_get_ticks(const zh_encoder_handle_t *handle, int64_t *ticks)
+{
+    ZH_ERROR_CHECK(handle != NULL && ticks != NULL, ESP_ERR_INVALID_ARG, NULL, "Encoder get ticks failed. Invalid argument.");
+    ZH_ERROR_CHECK(handle->is_initialized == true, ESP_FAIL, NULL, "Encoder get ticks failed. Encoder not initialized.");
+    zh_encoder_snapshot_t snapshot = {0};
+    _zh_encoder_snapshot_get(handle, &snapshot);
+    *ticks = snapshot.encoder_ticks;
+    return ESP_OK;
+}
+
+esp_err_t zh_encoder_get_snapshot(const zh_encoder_handle_t *handle, zh_encoder_snapshot_t *snapshot)
+{
+    ZH_ERROR_CHECK(handle != NULL && snapshot != NULL, ESP_ERR_INVALID_ARG, NULL, "Encoder get snapshot failed. Invalid argument.");
+    ZH_ERROR_CHECK(handle->is_initialized == true, ESP_FAIL, NULL, "Encoder get snapshot failed. Encoder not initialized.");
+    _zh_encoder_snapshot_get(handle, snapshot);
+    return ESP_OK;
+}
+
+void zh_encoder_read(const zh_encoder_handle_t *handle, zh_encoder_snapshot_t *snapshot)
+{
+    _zh_encoder_snapshot_get(handle, snapshot);
+}
+
+esp_err_t zh_encoder_get_velocity(const zh_encoder_handle_t *handle, float *velocity)
+{
+    ZH_ERROR_CHECK(handle != NULL && velocity != NULL, ESP_ERR_INVALID_ARG, NULL, "Encoder get velocity failed. Invalid argument.");
+    ZH_ERROR_CHECK(handle->is_initialized == true, ESP_FAIL, NULL, "Encoder get velocity failed. Encoder not initialized.");
+    *velocity = _zh_encoder_velocity_get(handle, esp_timer_get_time());
+    return ESP_OK;
+}
+
+esp_err_t zh_encoder_get_snapshot_all(zh_encoder_snapshot_t *snapshots, uint8_t size, uint8_t *quantity)
+{
+    ZH_ERROR_CHECK(snapshots != NULL && quantity != NULL && size > 0, ESP_ERR_INVALID_ARG, NULL, "Encoder get all snapshots failed. Invalid argument.");
+    int count[ZH_ENCODER_MAX_QUANTITY] = {0};
+    zh_encoder_handle_t *handle_matrix[ZH_ENCODER_MAX_QUANTITY] = {NULL};
+    uint8_t handle_quantity = 0;
+    for (uint8_t i = 0; i < ZH_ENCODER_MAX_QUANTITY && handle_quantity < size; ++i)
+    {
+        zh_encoder_handle_t *handle = _encoder_handle_matrix[i];
+        if (handle != NULL)
+        {
+            count[handle_quantity] = _zh_encoder_snapshot_count(handle);
+            handle_matrix[handle_quantity++] = handle;
+        }
+    }
+    uint32_t sequence = 0;
+    do
+    {
+        sequence = __atomic_load_n(&_state_sequence, __ATOMIC_ACQUIRE);
+        for (uint8_t i = 0; i < handle_quantity; ++i)
+        {
+            _zh_encoder_snapshot_read(handle_matrix[i], count[i], &snapshots[i]);
+        }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((sequence & 1) != 0 || sequence != __atomic_load_n(&_state_sequence, __ATOMIC_RELAXED));
+    *quantity = handle_quantity;
+    return ESP_OK;
+}
+
+esp_err_t zh_encoder_wait(zh_encoder_handle_t *const *handles, uint8_t quantity, TickType_t timeout, zh_encoder_snapshot_t *snapshots, uint32_t *changed)
+{
+    ZH_ERROR_CHECK(handles != NULL && snapshots != NULL && quantity > 0 && quantity <= ZH_ENCODER_MAX_QUANTITY, ESP_ERR_INVALID_ARG, NULL, "Encoder wait failed. Invalid argument.");
+    uint32_t slot_mask = 0;
+    for (uint8_t i = 0; i < quantity; ++i)
+    {
+        ZH_ERROR_CHECK(handles[i] != NULL, ESP_ERR_INVALID_ARG, NULL, "Encoder wait failed. Invalid argument.");
+        ZH_ERROR_CHECK(handles[i]->is_initialized == true, ESP_FAIL, NULL, "Encoder wait failed. Encoder not initialized.");
+        slot_mask |= 1UL << handles[i]->encoder_index;
+    }
+    zh_encoder_waiter_t *waiter = NULL;
+    taskENTER_CRITICAL(&_spinlock);
+    for (uint8_t i = 0; i < ZH_ENCODER_MAX_WAITERS; ++i)
+    {
+        if (_waiter[i].task_handle == NULL)
+        {
+            waiter = &_waiter[i];
+            waiter->task_handle = xTaskGetCurrentTaskHandle();
+            waiter->slot_mask = slot_mask;
+            waiter->changed_mask = 0;
+            _waiter_slot_mask |= slot_mask;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL(&_spinlock);
+    ZH_ERROR_CHECK(waiter != NULL, ESP_ERR_NO_MEM, NULL, "Encoder wait failed. Maximum quantity of waiting tasks reached.");
+    TimeOut_t time_out = {0};
+    vTaskSetTimeOutState(&time_out);
+    TickType_t wait_time = timeout;
+    while (__atomic_load_n(&waiter->changed_mask, __ATOMIC_ACQUIRE) == 0)
+    {
+        ulTaskNotifyTake(pdTRUE, wait_time);
+        if (xTaskCheckForTimeOut(&time_out, &wait_time) == pdTRUE)
+        {
+            break;
+        }
+    }
+    taskENTER_CRITICAL(&_spinlock);
+    uint32_t changed_mask = waiter->changed_mask;
+    waiter->task_handle = NULL;
+    _zh_encoder_waiter_mask_update();
+    taskEXIT_CRITICAL(&_spinlock);
+    uint32_t changed_set = 0;
+    for (uint8_t i = 0; i < quantity; ++i)
+    {
+        _zh_encoder_snapshot_get(handles[i], &snapshots[i]);
+        if ((changed_mask & (1UL << handles[i]->encoder_index)) != 0)
+        {
+            changed_set |= 1UL << i;
+        }
+    }
+    if (changed != NULL)
+    {
+        *changed = changed_set;
+    }
+    return (changed_mask != 0) ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+esp_err_t zh_encoder_home(zh_encoder_handle_t *handle)
+{
+    ZH_LOGI("Encoder homing started.");
+    ZH_ERROR_CHECK(handle != NULL, ESP_ERR_INVALID_ARG, NULL, "Encoder homing failed. Invalid argument.");
+    ZH_ERROR_CHECK(handle->is_initialized == true, ESP_FAIL, NULL, "Encoder homing failed. Encoder not initialized.");
+    ZH_ERROR_CHECK(handle->z_gpio_number != GPIO_NUM_MAX, ESP_ERR_INVALID_ARG, NULL, "Encoder homing failed. Index GPIO not configured.");
+    taskENTER_CRITICAL(&_spinlock);
+    handle->index_homing = true;
+    handle->index_homed = false;
+    taskEXIT_CRITICAL(&_spinlock);
+    ZH_LOGI("Encoder homing armed successfully.");
+    return ESP_OK;
+}
+
+esp_err_t zh_encoder_get_index(const zh_encoder_handle_t *handle, zh_encoder_index_event_t *index)
+{
+    ZH_ERROR_CHECK(handle != NULL && index != NULL, ESP_ERR_INVALID_ARG, NULL, "Encoder get index failed. Invalid argument.");
+    ZH_ERROR_CHECK(handle->is_initialized == true, ESP_FAIL, NULL, "Encoder get index failed. Encoder not initialized.");
+    ZH_ERROR_CHECK(handle->z_gpio_number != GPIO_NUM_MAX, ESP_ERR_INVALID_ARG, NULL, "Encoder get index failed. Index GPIO not configured.");
+    taskENTER_CRITICAL(&_spinlock);
+    index->encoder_position = handle->index_encoder_position;
+    index->position_error = handle->index_error;
+    index->index_count = handle->index_count;
+    index->encoder_number = handle->encoder_number;
+    index->is_homed = handle->index_homed;
+    index->is_corrected = handle->index_corrected;
+    taskEXIT_CRITICAL(&_spinlock);
     return ESP_OK;
 }
 
@@ -161,13 +529,126 @@ esp_err_t zh_encoder_reset(zh_encoder_handle_t *handle)
     ZH_LOGI("Encoder reset started.");
     ZH_ERROR_CHECK(handle != NULL, ESP_ERR_INVALID_ARG, NULL, "Encoder reset failed. Invalid argument.");
     ZH_ERROR_CHECK(handle->is_initialized == true, ESP_FAIL, NULL, "Encoder reset failed. Encoder not initialized.");
+    _zh_encoder_counter_steps(handle);
     taskENTER_CRITICAL(&_spinlock);
-    handle->encoder_position = (handle->encoder_min_value + handle->encoder_max_value) / 2;
+    _zh_encoder_state_write_begin();
+    _zh_encoder_origin_set(handle, ((double)handle->encoder_min_value + handle->encoder_max_value) / 2);
+    _zh_encoder_state_write_end();
     taskEXIT_CRITICAL(&_spinlock);
+    _zh_encoder_persistence_request(handle);
+    _zh_encoder_waiter_notify(handle);
     ZH_LOGI("Encoder reset completed successfully.");
     return ESP_OK;
 }
 
+esp_err_t zh_encoder_get_metrics(const zh_encoder_handle_t *handle, zh_encoder_metrics_t *metrics)
+{
+    ZH_LOGI("Encoder get metrics started.");
+    ZH_ERROR_CHECK(handle != NULL && metrics != NULL, ESP_ERR_INVALID_ARG, NULL, "Encoder get metrics failed. Invalid argument.");
+    ZH_ERROR_CHECK(handle->is_initialized == true, ESP_FAIL, NULL, "Encoder get metrics failed. Encoder not initialized.");
+    uint32_t sequence = 0;
+    do
+    {
+        sequence = __atomic_load_n(&handle->metrics_sequence, __ATOMIC_ACQUIRE);
+        memcpy(metrics, (const void *)&handle->metrics, sizeof(zh_encoder_metrics_t));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((sequence & 1) != 0 || sequence != __atomic_load_n(&handle->metrics_sequence, __ATOMIC_RELAXED));
+    ZH_LOGI("Encoder get metrics completed successfully.");
+    return ESP_OK;
+}
+
+esp_err_t zh_encoder_trace_start(zh_encoder_trace_record_t *buffer, uint16_t size)
+{
+    ZH_LOGI("Encoder trace start started.");
+    ZH_ERROR_CHECK(buffer != NULL && size > 0, ESP_ERR_INVALID_ARG, NULL, "Encoder trace start failed. Invalid argument.");
+    taskENTER_CRITICAL(&_spinlock);
+    _trace_buffer = buffer;
+    _trace_size = size;
+    _trace_head = 0;
+    _trace_enabled = true;
+    taskEXIT_CRITICAL(&_spinlock);
+    ZH_LOGI("Encoder trace start completed successfully.");
+    return ESP_OK;
+}
+
+void zh_encoder_trace_freeze(void)
+{
+    taskENTER_CRITICAL(&_spinlock);
+    _trace_enabled = false;
+    taskEXIT_CRITICAL(&_spinlock);
+}
+
+esp_err_t zh_encoder_trace_export(zh_encoder_trace_record_t *records, uint16_t size, uint16_t *quantity)
+{
+    ZH_LOGI("Encoder trace export started.");
+    ZH_ERROR_CHECK(records != NULL && quantity != NULL, ESP_ERR_INVALID_ARG, NULL, "Encoder trace export failed. Invalid argument.");
+    ZH_ERROR_CHECK(_trace_buffer != NULL && _trace_enabled == false, ESP_ERR_INVALID_STATE, NULL, "Encoder trace export failed. Trace is not frozen.");
+    uint32_t trace_head = _trace_head;
+    uint32_t trace_quantity = (trace_head < _trace_size) ? trace_head : _trace_size;
+    if (trace_quantity > size)
+    {
+        trace_quantity = size;
+    }
+    for (uint32_t i = 0; i < trace_quantity; ++i)
+    {
+        records[i] = _trace_buffer[(trace_head - trace_quantity + i) % _trace_size];
+    }
+    *quantity = trace_quantity;
+    ZH_LOGI("Encoder trace export completed successfully.");
+    return ESP_OK;
+}
+
+esp_err_t zh_encoder_trace_replay(const zh_encoder_trace_record_t *records, uint16_t quantity)
+{
+    ZH_LOGI("Encoder trace replay started.");
+    ZH_ERROR_CHECK(records != NULL, ESP_ERR_INVALID_ARG, NULL, "Encoder trace replay failed. Invalid argument.");
+    int64_t start_time = esp_timer_get_time();
+    for (uint16_t i = 0; i < quantity; ++i)
+    {
+        const zh_encoder_trace_record_t *record = &records[i];
+        int64_t record_time = start_time + (uint32_t)(record->time - records[0].time);
+        int64_t time_left = record_time - esp_timer_get_time();
+        if (time_left >= 1000LL * portTICK_PERIOD_MS)
+        {
+            vTaskDelay(pdMS_TO_TICKS(time_left / 1000));
+        }
+        zh_encoder_handle_t *handle = NULL;
+        for (uint8_t j = 0; j < ZH_ENCODER_MAX_QUANTITY && handle == NULL; ++j)
+        {
+            if (_encoder_handle_matrix[j] != NULL && _encoder_handle_matrix[j]->encoder_number == record->encoder_number && _encoder_handle_matrix[j]->backend == ZH_ENCODER_BACKEND_REPLAY)
+            {
+                handle = _encoder_handle_matrix[j];
+            }
+        }
+        if (handle == NULL)
+        {
+            continue;
+        }
+        if (record->type == ZH_ENCODER_TRACE_STEP && _zh_encoder_step_apply(handle, record->value, (uint32_t)record_time) == true)
+        {
+            xTaskNotifyGive(handle->task_handle);
+        }
+        else if (record->type == ZH_ENCODER_TRACE_BUTTON && handle->s_gpio_number != GPIO_NUM_MAX)
+        {
+            __atomic_store_n(&handle->s_gpio_replay_level, record->value != 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&handle->button_edge_time, (uint32_t)record_time, __ATOMIC_RELAXED);
+            __atomic_store_n(&handle->button_edge_pending, true, __ATOMIC_RELEASE);
+            xTaskNotifyGive(handle->task_handle);
+        }
+        else if (record->type == ZH_ENCODER_TRACE_DROP)
+        {
+            __atomic_fetch_add(&handle->metrics.step_drop_count, record->value, __ATOMIC_RELAXED);
+        }
+        else if (record->type == ZH_ENCODER_TRACE_INDEX && handle->z_gpio_number != GPIO_NUM_MAX)
+        {
+            _zh_encoder_index_latch(handle);
+            xTaskNotifyGive(handle->task_handle);
+        }
+    }
+    ZH_LOGI("Encoder trace replay completed successfully.");
+    return ESP_OK;
+}
+
 const zh_encoder_stats_t *zh_encoder_get_stats(void)
 {
     return &_stats;
@@ -186,18 +667,182 @@ static esp_err_t _zh_encoder_validate_config(const zh_encoder_init_config_t *con
 {
     ZH_ERROR_CHECK(config->task_priority >= 1 && config->stack_size >= configMINIMAL_STACK_SIZE, ESP_ERR_INVALID_ARG, NULL, "Invalid task settings.");
     ZH_ERROR_CHECK(config->queue_size >= 1, ESP_ERR_INVALID_ARG, NULL, "Invalid queue size.");
-    ZH_ERROR_CHECK(config->encoder_max_value > config->encoder_min_value, ESP_ERR_INVALID_ARG, NULL, "Invalid encoder min/max value.");
-    ZH_ERROR_CHECK(config->encoder_step > 0, ESP_ERR_INVALID_ARG, NULL, "Invalid encoder step.");
+    ZH_ERROR_CHECK(_zh_encoder_profile_validate(config) == ESP_OK, ESP_ERR_INVALID_ARG, NULL, "Invalid encoder profile.");
     ZH_ERROR_CHECK(config->encoder_number > 0, ESP_ERR_INVALID_ARG, NULL, "Invalid encoder number.");
-    for (uint8_t i = 0; i < sizeof(_encoder_number_matrix); ++i)
+    if (config->counter_mode == true)
+    {
+        ZH_ERROR_CHECK(config->counter_high_limit > 0 && config->counter_low_limit < 0, ESP_ERR_INVALID_ARG, NULL, "Invalid counter limits.");
+        ZH_ERROR_CHECK(config->counter_event_period > 0, ESP_ERR_INVALID_ARG, NULL, "Invalid counter event period.");
+    }
+    if (config->batch_mode == true)
+    {
+        ZH_ERROR_CHECK(config->batch_frame_period > 0, ESP_ERR_INVALID_ARG, NULL, "Invalid batch frame period.");
+        ZH_ERROR_CHECK(_batch_frame_period == 0 || _batch_frame_period == config->batch_frame_period, ESP_ERR_INVALID_ARG, NULL, "Batch frame period differs from other encoders.");
+    }
+    for (uint8_t i = 1; i < ZH_ENCODER_ACCELERATION_TABLE_SIZE && config->acceleration[i].multiplier != 0; ++i)
+    {
+        ZH_ERROR_CHECK(config->acceleration[i].step_rate > config->acceleration[i - 1].step_rate, ESP_ERR_INVALID_ARG, NULL, "Invalid acceleration table.");
+    }
+    ZH_ERROR_CHECK(config->isr_callback == NULL || config->counter_mode == false, ESP_ERR_INVALID_ARG, NULL, "Invalid callback settings.");
+    ZH_ERROR_CHECK(config->backend == ZH_ENCODER_BACKEND_PCNT || config->backend == ZH_ENCODER_BACKEND_SOFTWARE || config->backend == ZH_ENCODER_BACKEND_REPLAY, ESP_ERR_INVALID_ARG, NULL, "Invalid encoder backend.");
+    ZH_ERROR_CHECK(config->task_group < ZH_ENCODER_MAX_TASK_GROUPS, ESP_ERR_INVALID_ARG, NULL, "Invalid task group.");
+    ZH_ERROR_CHECK(config->task_core >= -1 && config->task_core < portNUM_PROCESSORS, ESP_ERR_INVALID_ARG, NULL, "Invalid task core.");
+    ZH_ERROR_CHECK((config->task_stack == NULL) == (config->task_tcb == NULL), ESP_ERR_INVALID_ARG, NULL, "Invalid task buffers.");
+#ifdef CONFIG_ZH_ENCODER_STATIC_ALLOCATION
+    ZH_ERROR_CHECK(config->task_stack != NULL || config->stack_size <= CONFIG_ZH_ENCODER_STATIC_STACK_SIZE, ESP_ERR_INVALID_ARG, NULL, "Task stack size exceeds the static stack buffer.");
+#endif
+    const zh_encoder_task_group_t *task_group = &_task_group[config->task_group];
+    for (uint8_t i = 0; i < ZH_ENCODER_MAX_QUANTITY && config->batch_mode == true; ++i)
     {
-        ZH_ERROR_CHECK(config->encoder_number != _encoder_number_matrix[i], ESP_ERR_INVALID_ARG, NULL, "Encoder number already present.");
+        const zh_encoder_handle_t *encoder_handle = _encoder_handle_matrix[i];
+        ZH_ERROR_CHECK(encoder_handle == NULL || encoder_handle->batch_mode == false || encoder_handle->task_group != config->task_group || encoder_handle->event_loop == config->event_loop,
+                       ESP_ERR_INVALID_ARG, NULL, "Event loop differs from other encoders in batch mode in the task group.");
     }
+    ZH_ERROR_CHECK(task_group->task_handle == NULL || (task_group->task_priority == config->task_priority && task_group->stack_size == config->stack_size &&
+                                                       task_group->queue_size == config->queue_size && task_group->task_core == config->task_core),
+                   ESP_ERR_INVALID_ARG, NULL, "Task settings differ from other encoders in the task group.");
+    ZH_ERROR_CHECK(config->resolution == ZH_ENCODER_RESOLUTION_X1 || config->resolution == ZH_ENCODER_RESOLUTION_X2 || config->resolution == ZH_ENCODER_RESOLUTION_X4, ESP_ERR_INVALID_ARG, NULL, "Invalid encoder resolution.");
+    ZH_ERROR_CHECK(config->counts_per_step > 0, ESP_ERR_INVALID_ARG, NULL, "Invalid encoder counts per step.");
+    ZH_ERROR_CHECK(config->backend == ZH_ENCODER_BACKEND_PCNT || config->counter_mode == false, ESP_ERR_INVALID_ARG, NULL, "Counter mode is only supported by PCNT backend.");
+    ZH_ERROR_CHECK(config->velocity_alpha >= 0 && config->velocity_alpha <= 1 && config->velocity_beta >= 0 && config->velocity_beta <= 1, ESP_ERR_INVALID_ARG, NULL, "Invalid velocity filter gains.");
+    if (config->z_gpio_number != GPIO_NUM_MAX)
+    {
+        ZH_ERROR_CHECK(config->index_mode == ZH_ENCODER_INDEX_LATCH || config->index_mode == ZH_ENCODER_INDEX_RESET, ESP_ERR_INVALID_ARG, NULL, "Invalid index mode.");
+        ZH_ERROR_CHECK(config->index_position >= config->encoder_min_value && config->index_position <= config->encoder_max_value, ESP_ERR_INVALID_ARG, NULL, "Invalid index position.");
+        ZH_ERROR_CHECK(config->acceleration[0].multiplier == 0, ESP_ERR_INVALID_ARG, NULL, "Index is not supported with acceleration.");
+    }
+    ZH_ERROR_CHECK((_encoder_number_bitmap[config->encoder_number >> 5] & (1UL << (config->encoder_number & 31))) == 0, ESP_ERR_INVALID_ARG, NULL, "Encoder number already present.");
     handle->encoder_number = config->encoder_number;
     handle->encoder_min_value = config->encoder_min_value;
     handle->encoder_max_value = config->encoder_max_value;
     handle->encoder_step = config->encoder_step;
-    handle->encoder_position = (handle->encoder_min_value + handle->encoder_max_value) / 2;
+    _zh_encoder_origin_set(handle, ((double)handle->encoder_min_value + handle->encoder_max_value) / 2);
+    handle->encoder_step_time = 0;
+    handle->encoder_direction = 0;
+    handle->counts_per_step = config->counts_per_step;
+    handle->task_group = config->task_group;
+    handle->hysteresis_count = (config->hysteresis_count > 1) ? config->hysteresis_count : 1;
+    handle->hysteresis_window = config->hysteresis_window;
+    handle->hysteresis_direction = 0;
+    handle->hysteresis_reversals = 0;
+    handle->hysteresis_time = 0;
+    handle->batch_mode = config->batch_mode;
+    handle->batch_step_count = 0;
+    handle->event_timeout = config->event_timeout;
+    handle->event_min_interval = config->event_min_interval;
+    handle->event_coalescing = config->event_coalescing;
+    handle->event_pending = false;
+    handle->event_prev_time = 0;
+    handle->callback = config->callback;
+    handle->callback_arg = config->callback_arg;
+    handle->isr_callback = config->isr_callback;
+    handle->callback_in_isr = (config->isr_callback != NULL);
+    handle->event_loop = config->event_loop;
+    handle->isr_ticks_delta = 0;
+    memcpy(handle->acceleration, config->acceleration, sizeof(handle->acceleration));
+    handle->acceleration_prev_time = 0;
+    handle->acceleration_direction = 0;
+    handle->velocity_window = config->velocity_window;
+    handle->velocity_alpha = config->velocity_alpha;
+    handle->velocity_beta = config->velocity_beta;
+    handle->velocity_direction = 0;
+    handle->velocity_window_time = 0;
+    handle->velocity_window_steps = 0;
+    handle->velocity_offset = 0;
+    handle->velocity = 0;
+    handle->velocity_step_time = 0;
+    handle->wrap_around = config->wrap_around;
+    handle->index_mode = config->index_mode;
+    handle->index_position = config->index_position;
+    handle->index_pending = false;
+    handle->index_homing = false;
+    handle->index_homed = false;
+    handle->index_corrected = false;
+    handle->index_count = 0;
+    handle->index_encoder_position = 0;
+    handle->index_error = 0;
+    handle->index_step_total = 0;
+    handle->index_step_applied = 0;
+    _zh_encoder_profile_build(config, &handle->profile);
+    handle->mapping_profile = &handle->profile;
+    memset((void *)&handle->metrics, 0, sizeof(handle->metrics));
+    handle->metrics_sequence = 0;
+    handle->pending_time = 0;
+    return ESP_OK;
+}
+
+static esp_err_t _zh_encoder_init_one(const zh_encoder_init_config_t *config, zh_encoder_handle_t *handle) // -V2008
+{
+    ZH_ERROR_CHECK(_zh_encoder_persistence_init(config, handle) == ESP_OK, ESP_FAIL, NULL, "Persistence initialization failed.");
+    ZH_ERROR_CHECK(_zh_encoder_task_init(config, handle) == ESP_OK, ESP_FAIL, NULL, "Processing task initialization failed.");
+    ZH_ERROR_CHECK(_zh_encoder_decoder_init(config, handle) == ESP_OK, ESP_FAIL,
+                   _zh_encoder_task_deinit(handle), "Decoder initialization failed.");
+    ZH_ERROR_CHECK(_zh_encoder_counter_init(config, handle) == ESP_OK, ESP_FAIL,
+                   ZH_ERROR_CHECK(pcnt_unit_stop(handle->pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT unit stop fail.");
+                   ZH_ERROR_CHECK(pcnt_unit_disable(handle->pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT unit disable fail.");
+                   ZH_ERROR_CHECK(pcnt_del_channel(handle->pcnt_channel_a_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
+                   ZH_ERROR_CHECK(pcnt_del_channel(handle->pcnt_channel_b_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
+                   ZH_ERROR_CHECK(pcnt_del_unit(handle->pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete unit fail.");
+                   _zh_encoder_task_deinit(handle), "Counter initialization failed.");
+    ZH_ERROR_CHECK(_zh_encoder_gpio_init(config, handle) == ESP_OK, ESP_FAIL,
+                   if (handle->counter_mode == true) {
+                       esp_timer_stop(handle->counter_timer_handle);
+                       esp_timer_delete(handle->counter_timer_handle);
+                   }
+                   if (handle->backend == ZH_ENCODER_BACKEND_SOFTWARE) {
+                       gpio_isr_handler_remove((gpio_num_t)handle->a_gpio_number);
+                       gpio_isr_handler_remove((gpio_num_t)handle->b_gpio_number);
+                       gpio_reset_pin((gpio_num_t)handle->a_gpio_number);
+                       gpio_reset_pin((gpio_num_t)handle->b_gpio_number);
+                   } else if (handle->backend == ZH_ENCODER_BACKEND_PCNT) {
+                       ZH_ERROR_CHECK(pcnt_unit_stop(handle->pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT unit stop fail.");
+                       ZH_ERROR_CHECK(pcnt_unit_disable(handle->pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT unit disable fail.");
+                       ZH_ERROR_CHECK(pcnt_del_channel(handle->pcnt_channel_a_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
+                       ZH_ERROR_CHECK(pcnt_del_channel(handle->pcnt_channel_b_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
+                       ZH_ERROR_CHECK(pcnt_del_unit(handle->pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete unit fail.");
+                   }
+                   _zh_encoder_task_deinit(handle), "GPIO initialization failed.");
+    if (_stats.min_stack_size == 0)
+    {
+        _stats.min_stack_size = config->stack_size;
+    }
+    handle->is_initialized = true;
+    taskENTER_CRITICAL(&_spinlock);
+    if (handle->batch_mode == true)
+    {
+        _batch_frame_period = config->batch_frame_period;
+    }
+    ++_encoder_counter;
+    ++_task_group[handle->task_group].encoder_counter;
+    if (handle->persistence == true)
+    {
+        ++_persistence_counter;
+    }
+    handle->encoder_index = __builtin_ctz(~_encoder_slot_bitmap);
+    _encoder_slot_bitmap |= 1UL << handle->encoder_index;
+    _encoder_number_bitmap[handle->encoder_number >> 5] |= 1UL << (handle->encoder_number & 31);
+    _encoder_handle_matrix[handle->encoder_index] = handle;
+    taskEXIT_CRITICAL(&_spinlock);
+    return ESP_OK;
+}
+
+static esp_err_t _zh_encoder_profile_validate(const zh_encoder_init_config_t *config)
+{
+    ZH_ERROR_CHECK(config->encoder_max_value > config->encoder_min_value, ESP_ERR_INVALID_ARG, NULL, "Invalid encoder min/max value.");
+    ZH_ERROR_CHECK(config->encoder_step > 0, ESP_ERR_INVALID_ARG, NULL, "Invalid encoder step.");
+    ZH_ERROR_CHECK(config->mapping == ZH_ENCODER_MAPPING_LINEAR || config->mapping == ZH_ENCODER_MAPPING_LOG || config->mapping == ZH_ENCODER_MAPPING_EXP || config->mapping == ZH_ENCODER_MAPPING_TABLE, ESP_ERR_INVALID_ARG, NULL, "Invalid value mapping.");
+    if (config->mapping == ZH_ENCODER_MAPPING_LOG || config->mapping == ZH_ENCODER_MAPPING_EXP)
+    {
+        ZH_ERROR_CHECK(config->mapping_curvature > 0, ESP_ERR_INVALID_ARG, NULL, "Invalid value mapping curvature.");
+    }
+    if (config->mapping == ZH_ENCODER_MAPPING_TABLE)
+    {
+        ZH_ERROR_CHECK(config->mapping_table_size >= 2 && config->mapping_table_size <= ZH_ENCODER_MAPPING_TABLE_SIZE, ESP_ERR_INVALID_ARG, NULL, "Invalid value mapping table size.");
+        for (uint8_t i = 1; i < config->mapping_table_size; ++i)
+        {
+            ZH_ERROR_CHECK(config->mapping_table[i].position > config->mapping_table[i - 1].position, ESP_ERR_INVALID_ARG, NULL, "Invalid value mapping table.");
+        }
+    }
     return ESP_OK;
 }
 
@@ -206,15 +851,35 @@ static esp_err_t _zh_encoder_pcnt_init(const zh_encoder_init_config_t *config, z
     ZH_ERROR_CHECK(config->a_gpio_number < GPIO_NUM_MAX && config->b_gpio_number < GPIO_NUM_MAX, ESP_ERR_INVALID_ARG, NULL, "Invalid GPIO number.")
     ZH_ERROR_CHECK(config->a_gpio_number != config->b_gpio_number, ESP_ERR_INVALID_ARG, NULL, "Encoder A and B GPIO is same.")
     pcnt_unit_config_t pcnt_unit_config = {
-        .high_limit = 10,
-        .low_limit = -10,
+        .high_limit = (config->counter_mode == true) ? config->counter_high_limit : config->counts_per_step + 10,
+        .low_limit = (config->counter_mode == true) ? config->counter_low_limit : -config->counts_per_step - 10,
+        .flags.accum_count = config->counter_mode,
     };
+    int high_watch_point = (config->counter_mode == true) ? config->counter_high_limit : config->counts_per_step;
+    int low_watch_point = (config->counter_mode == true) ? config->counter_low_limit : -config->counts_per_step;
+    pcnt_channel_edge_action_t a_edge_action[2] = {PCNT_CHANNEL_EDGE_ACTION_DECREASE, PCNT_CHANNEL_EDGE_ACTION_HOLD};
+    pcnt_channel_level_action_t a_level_action[2] = {PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_HOLD};
+    pcnt_channel_edge_action_t b_edge_action[2] = {PCNT_CHANNEL_EDGE_ACTION_INCREASE, PCNT_CHANNEL_EDGE_ACTION_HOLD};
+    pcnt_channel_level_action_t b_level_action[2] = {PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_HOLD};
+    if (config->resolution != ZH_ENCODER_RESOLUTION_X1)
+    {
+        a_edge_action[1] = PCNT_CHANNEL_EDGE_ACTION_INCREASE;
+        a_level_action[1] = PCNT_CHANNEL_LEVEL_ACTION_INVERSE;
+        b_edge_action[0] = PCNT_CHANNEL_EDGE_ACTION_HOLD;
+        b_level_action[1] = PCNT_CHANNEL_LEVEL_ACTION_KEEP;
+    }
+    if (config->resolution == ZH_ENCODER_RESOLUTION_X4)
+    {
+        b_edge_action[0] = PCNT_CHANNEL_EDGE_ACTION_INCREASE;
+        b_edge_action[1] = PCNT_CHANNEL_EDGE_ACTION_DECREASE;
+        b_level_action[1] = PCNT_CHANNEL_LEVEL_ACTION_INVERSE;
+    }
     pcnt_unit_handle_t pcnt_unit_handle = NULL;
     ZH_ERROR_CHECK(pcnt_new_unit(&pcnt_unit_config, &pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT initialization failed.");
     pcnt_glitch_filter_config_t pcnt_glitch_filter_config = {
-        .max_glitch_ns = 1000,
+        .max_glitch_ns = config->glitch_filter_ns,
     };
-    ZH_ERROR_CHECK(pcnt_unit_set_glitch_filter(pcnt_unit_handle, &pcnt_glitch_filter_config) == ESP_OK, ESP_FAIL,
+    ZH_ERROR_CHECK(pcnt_unit_set_glitch_filter(pcnt_unit_handle, (config->glitch_filter_ns != 0) ? &pcnt_glitch_filter_config : NULL) == ESP_OK, ESP_FAIL,
                    ZH_ERROR_CHECK(pcnt_del_unit(pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete unit fail."), "PCNT initialization failed.");
     pcnt_chan_config_t pcnt_chan_a_config = {
         .edge_gpio_num = config->a_gpio_number,
@@ -231,57 +896,57 @@ static esp_err_t _zh_encoder_pcnt_init(const zh_encoder_init_config_t *config, z
     ZH_ERROR_CHECK(pcnt_new_channel(pcnt_unit_handle, &pcnt_chan_b_config, &pcnt_channel_b_handle) == ESP_OK, ESP_FAIL,
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_a_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_unit(pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete unit fail."), "PCNT initialization failed.");
-    ZH_ERROR_CHECK(pcnt_channel_set_edge_action(pcnt_channel_a_handle, PCNT_CHANNEL_EDGE_ACTION_DECREASE, PCNT_CHANNEL_EDGE_ACTION_HOLD) == ESP_OK, ESP_FAIL,
+    ZH_ERROR_CHECK(pcnt_channel_set_edge_action(pcnt_channel_a_handle, a_edge_action[0], a_edge_action[1]) == ESP_OK, ESP_FAIL,
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_a_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_b_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_unit(pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete unit fail."), "PCNT initialization failed.");
-    ZH_ERROR_CHECK(pcnt_channel_set_level_action(pcnt_channel_a_handle, PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_HOLD) == ESP_OK, ESP_FAIL,
+    ZH_ERROR_CHECK(pcnt_channel_set_level_action(pcnt_channel_a_handle, a_level_action[0], a_level_action[1]) == ESP_OK, ESP_FAIL,
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_a_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_b_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_unit(pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete unit fail."), "PCNT initialization failed.");
-    ZH_ERROR_CHECK(pcnt_channel_set_edge_action(pcnt_channel_b_handle, PCNT_CHANNEL_EDGE_ACTION_INCREASE, PCNT_CHANNEL_EDGE_ACTION_HOLD) == ESP_OK, ESP_FAIL,
+    ZH_ERROR_CHECK(pcnt_channel_set_edge_action(pcnt_channel_b_handle, b_edge_action[0], b_edge_action[1]) == ESP_OK, ESP_FAIL,
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_a_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_b_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_unit(pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete unit fail."), "PCNT initialization failed.");
-    ZH_ERROR_CHECK(pcnt_channel_set_level_action(pcnt_channel_b_handle, PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_HOLD) == ESP_OK, ESP_FAIL,
+    ZH_ERROR_CHECK(pcnt_channel_set_level_action(pcnt_channel_b_handle, b_level_action[0], b_level_action[1]) == ESP_OK, ESP_FAIL,
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_a_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_b_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_unit(pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete unit fail."), "PCNT initialization failed.");
-    ZH_ERROR_CHECK(pcnt_unit_add_watch_point(pcnt_unit_handle, ZH_ENCODER_DIRECTION_CW) == ESP_OK, ESP_FAIL,
+    ZH_ERROR_CHECK(pcnt_unit_add_watch_point(pcnt_unit_handle, high_watch_point) == ESP_OK, ESP_FAIL,
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_a_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_b_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_unit(pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete unit fail."), "PCNT initialization failed.");
-    ZH_ERROR_CHECK(pcnt_unit_add_watch_point(pcnt_unit_handle, ZH_ENCODER_DIRECTION_CCW) == ESP_OK, ESP_FAIL,
-                   ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit_handle, ZH_ENCODER_DIRECTION_CW) == ESP_OK, ESP_FAIL, NULL, "PCNT unit remove watch point fail.");
+    ZH_ERROR_CHECK(pcnt_unit_add_watch_point(pcnt_unit_handle, low_watch_point) == ESP_OK, ESP_FAIL,
+                   ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit_handle, high_watch_point) == ESP_OK, ESP_FAIL, NULL, "PCNT unit remove watch point fail.");
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_a_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_b_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_unit(pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete unit fail."), "PCNT initialization failed.");
     pcnt_event_callbacks_t cbs = {
-        .on_reach = _zh_encoder_isr_handler,
+        .on_reach = (config->counter_mode == true) ? _zh_encoder_counter_isr_handler : _zh_encoder_isr_handler,
     };
     ZH_ERROR_CHECK(pcnt_unit_register_event_callbacks(pcnt_unit_handle, &cbs, handle) == ESP_OK, ESP_FAIL,
-                   ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit_handle, ZH_ENCODER_DIRECTION_CW) == ESP_OK, ESP_FAIL, NULL, "PCNT unit remove watch point fail.");
-                   ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit_handle, ZH_ENCODER_DIRECTION_CCW) == ESP_OK, ESP_FAIL, NULL, "PCNT unit remove watch point fail.");
+                   ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit_handle, high_watch_point) == ESP_OK, ESP_FAIL, NULL, "PCNT unit remove watch point fail.");
+                   ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit_handle, low_watch_point) == ESP_OK, ESP_FAIL, NULL, "PCNT unit remove watch point fail.");
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_a_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_b_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_unit(pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete unit fail."), "PCNT initialization failed.");
     ZH_ERROR_CHECK(pcnt_unit_enable(pcnt_unit_handle) == ESP_OK, ESP_FAIL,
-                   ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit_handle, ZH_ENCODER_DIRECTION_CW) == ESP_OK, ESP_FAIL, NULL, "PCNT unit remove watch point fail.");
-                   ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit_handle, ZH_ENCODER_DIRECTION_CCW) == ESP_OK, ESP_FAIL, NULL, "PCNT unit remove watch point fail.");
+                   ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit_handle, high_watch_point) == ESP_OK, ESP_FAIL, NULL, "PCNT unit remove watch point fail.");
+                   ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit_handle, low_watch_point) == ESP_OK, ESP_FAIL, NULL, "PCNT unit remove watch point fail.");
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_a_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_b_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_unit(pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete unit fail."), "PCNT initialization failed.");
     ZH_ERROR_CHECK(pcnt_unit_clear_count(pcnt_unit_handle) == ESP_OK, ESP_FAIL,
                    ZH_ERROR_CHECK(pcnt_unit_disable(pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT unit disable fail.");
-                   ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit_handle, ZH_ENCODER_DIRECTION_CW) == ESP_OK, ESP_FAIL, NULL, "PCNT unit remove watch point fail.");
-                   ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit_handle, ZH_ENCODER_DIRECTION_CCW) == ESP_OK, ESP_FAIL, NULL, "PCNT unit remove watch point fail.");
+                   ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit_handle, high_watch_point) == ESP_OK, ESP_FAIL, NULL, "PCNT unit remove watch point fail.");
+                   ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit_handle, low_watch_point) == ESP_OK, ESP_FAIL, NULL, "PCNT unit remove watch point fail.");
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_a_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_b_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_unit(pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete unit fail."), "PCNT initialization failed.");
     ZH_ERROR_CHECK(pcnt_unit_start(pcnt_unit_handle) == ESP_OK, ESP_FAIL,
                    ZH_ERROR_CHECK(pcnt_unit_disable(pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT unit disable fail.");
-                   ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit_handle, ZH_ENCODER_DIRECTION_CW) == ESP_OK, ESP_FAIL, NULL, "PCNT unit remove watch point fail.");
-                   ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit_handle, ZH_ENCODER_DIRECTION_CCW) == ESP_OK, ESP_FAIL, NULL, "PCNT unit remove watch point fail.");
+                   ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit_handle, high_watch_point) == ESP_OK, ESP_FAIL, NULL, "PCNT unit remove watch point fail.");
+                   ZH_ERROR_CHECK(pcnt_unit_remove_watch_point(pcnt_unit_handle, low_watch_point) == ESP_OK, ESP_FAIL, NULL, "PCNT unit remove watch point fail.");
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_a_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_channel(pcnt_channel_b_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete channel fail.");
                    ZH_ERROR_CHECK(pcnt_del_unit(pcnt_unit_handle) == ESP_OK, ESP_FAIL, NULL, "PCNT delete unit fail."), "PCNT initialization failed.");
@@ -293,69 +958,649 @@ static esp_err_t _zh_encoder_pcnt_init(const zh_encoder_init_config_t *config, z
     handle->pcnt_unit_handle = pcnt_unit_handle;
     handle->pcnt_channel_a_handle = pcnt_channel_a_handle;
     handle->pcnt_channel_b_handle = pcnt_channel_b_handle;
+    handle->pcnt_high_watch_point = high_watch_point;
+    handle->pcnt_low_watch_point = low_watch_point;
+    handle->counter_mode = config->counter_mode;
+    handle->counter_value = 0;
+    handle->backend = ZH_ENCODER_BACKEND_PCNT;
     return ESP_OK;
 }
 
+static esp_err_t _zh_encoder_software_init(const zh_encoder_init_config_t *config, zh_encoder_handle_t *handle) // -V2008
+{
+    ZH_ERROR_CHECK(config->a_gpio_number < GPIO_NUM_MAX && config->b_gpio_number < GPIO_NUM_MAX, ESP_ERR_INVALID_ARG, NULL, "Invalid GPIO number.")
+    ZH_ERROR_CHECK(config->a_gpio_number != config->b_gpio_number, ESP_ERR_INVALID_ARG, NULL, "Encoder A and B GPIO is same.")
+    gpio_config_t pin_config = {
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = (config->pullup == true) ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE,
+        .pin_bit_mask = (1ULL << config->a_gpio_number) | (1ULL << config->b_gpio_number),
+        .intr_type = GPIO_INTR_ANYEDGE};
+    ZH_ERROR_CHECK(gpio_config(&pin_config) == ESP_OK, ESP_FAIL, NULL, "GPIO initialization failed.");
+    esp_err_t err = gpio_install_isr_service(ESP_INTR_FLAG_LOWMED);
+    ZH_ERROR_CHECK(err == ESP_OK || err == ESP_ERR_INVALID_STATE, ESP_FAIL,
+                   ZH_ERROR_CHECK(gpio_reset_pin((gpio_num_t)config->a_gpio_number) == ESP_OK, ESP_FAIL, NULL, "Reset GPIO failed.");
+                   ZH_ERROR_CHECK(gpio_reset_pin((gpio_num_t)config->b_gpio_number) == ESP_OK, ESP_FAIL, NULL, "Reset GPIO failed."), "Failed install isr service.");
+    handle->backend = ZH_ENCODER_BACKEND_SOFTWARE;
+    handle->a_gpio_number = config->a_gpio_number;
+    handle->b_gpio_number = config->b_gpio_number;
+    handle->software_state = (gpio_get_level((gpio_num_t)config->a_gpio_number) << 1) | gpio_get_level((gpio_num_t)config->b_gpio_number);
+    handle->software_transitions = 0;
+    handle->software_step_transitions = (ZH_ENCODER_SOFTWARE_STEP_TRANSITIONS >> config->resolution) * config->counts_per_step;
+    handle->counter_mode = false;
+    handle->counter_value = 0;
+    ZH_ERROR_CHECK(gpio_isr_handler_add((gpio_num_t)config->a_gpio_number, _zh_encoder_software_isr_handler, handle) == ESP_OK, ESP_FAIL,
+                   ZH_ERROR_CHECK(gpio_reset_pin((gpio_num_t)config->a_gpio_number) == ESP_OK, ESP_FAIL, NULL, "Reset GPIO failed.");
+                   ZH_ERROR_CHECK(gpio_reset_pin((gpio_num_t)config->b_gpio_number) == ESP_OK, ESP_FAIL, NULL, "Reset GPIO failed."), "Interrupt initialization failed.");
+    ZH_ERROR_CHECK(gpio_isr_handler_add((gpio_num_t)config->b_gpio_number, _zh_encoder_software_isr_handler, handle) == ESP_OK, ESP_FAIL,
+                   ZH_ERROR_CHECK(gpio_isr_handler_remove((gpio_num_t)config->a_gpio_number) == ESP_OK, ESP_FAIL, NULL, "Remove GPIO isr handler failed.");
+                   ZH_ERROR_CHECK(gpio_reset_pin((gpio_num_t)config->a_gpio_number) == ESP_OK, ESP_FAIL, NULL, "Reset GPIO failed.");
+                   ZH_ERROR_CHECK(gpio_reset_pin((gpio_num_t)config->b_gpio_number) == ESP_OK, ESP_FAIL, NULL, "Reset GPIO failed."), "Interrupt initialization failed.");
+    return ESP_OK;
+}
+
+static esp_err_t _zh_encoder_decoder_init(const zh_encoder_init_config_t *config, zh_encoder_handle_t *handle)
+{
+    switch (config->backend)
+    {
+    case ZH_ENCODER_BACKEND_SOFTWARE:
+        return _zh_encoder_software_init(config, handle);
+    case ZH_ENCODER_BACKEND_REPLAY:
+        handle->backend = ZH_ENCODER_BACKEND_REPLAY;
+        handle->counter_mode = false;
+        handle->counter_value = 0;
+        return ESP_OK;
+    default:
+        return _zh_encoder_pcnt_init(config, handle);
+    }
+}
+
 static esp_err_t _zh_encoder_gpio_init(const zh_encoder_init_config_t *config, zh_encoder_handle_t *handle) // -V2008
 {
     ZH_ERROR_CHECK(config->s_gpio_number <= GPIO_NUM_MAX, ESP_ERR_INVALID_ARG, NULL, "Invalid GPIO number.")
-    ZH_ERROR_CHECK(config->a_gpio_number != config->s_gpio_number && config->b_gpio_number != config->s_gpio_number, ESP_ERR_INVALID_ARG, NULL, "Encoder GPIO and button GPIO is same.")
+    ZH_ERROR_CHECK(config->backend == ZH_ENCODER_BACKEND_REPLAY || (config->a_gpio_number != config->s_gpio_number && config->b_gpio_number != config->s_gpio_number), ESP_ERR_INVALID_ARG, NULL, "Encoder GPIO and button GPIO is same.")
+    ZH_ERROR_CHECK(config->button_gestures == false || config->button_long_press_time > 0, ESP_ERR_INVALID_ARG, NULL, "Invalid button long press time.")
+    ZH_ERROR_CHECK(config->z_gpio_number <= GPIO_NUM_MAX, ESP_ERR_INVALID_ARG, NULL, "Invalid GPIO number.")
+    ZH_ERROR_CHECK(config->z_gpio_number == GPIO_NUM_MAX || config->backend == ZH_ENCODER_BACKEND_REPLAY ||
+                       (config->a_gpio_number != config->z_gpio_number && config->b_gpio_number != config->z_gpio_number && config->s_gpio_number != config->z_gpio_number),
+                   ESP_ERR_INVALID_ARG, NULL, "Encoder GPIO and index GPIO is same.")
+    handle->s_gpio_number = config->s_gpio_number;
     if (config->s_gpio_number != GPIO_NUM_MAX)
+    {
+        handle->s_gpio_debounce_time = config->s_gpio_debounce_time;
+        handle->s_gpio_prev_time = 0;
+        handle->button_gestures = config->button_gestures;
+        handle->button_active_low = config->button_active_low;
+        handle->button_long_press_time = config->button_long_press_time;
+        handle->button_double_click_time = config->button_double_click_time;
+        handle->button_repeat_period = config->button_repeat_period;
+        handle->button_edge_pending = false;
+        handle->button_debounce_pending = false;
+        handle->button_state = ZH_ENCODER_BUTTON_STATE_IDLE;
+        handle->button_repeat_count = 0;
+        handle->button_deadline = 0;
+        handle->s_gpio_replay_level = config->button_active_low;
+        if (config->backend == ZH_ENCODER_BACKEND_REPLAY)
+        {
+            handle->s_gpio_status = config->button_active_low;
+        }
+        else
+        {
+            gpio_config_t pin_config = {
+                .mode = GPIO_MODE_INPUT,
+                .pull_up_en = (config->pullup == true) ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE,
+                .pin_bit_mask = (1ULL << config->s_gpio_number),
+                .intr_type = GPIO_INTR_ANYEDGE};
+            ZH_ERROR_CHECK(gpio_config(&pin_config) == ESP_OK, ESP_FAIL, NULL, "GPIO initialization failed.");
+            esp_err_t err = gpio_install_isr_service(ESP_INTR_FLAG_LOWMED);
+            ZH_ERROR_CHECK(err == ESP_OK || err == ESP_ERR_INVALID_STATE, ESP_FAIL,
+                           ZH_ERROR_CHECK(gpio_reset_pin((gpio_num_t)config->s_gpio_number) == ESP_OK, ESP_FAIL, NULL, "Reset GPIO failed."), "Failed install isr service.");
+            ZH_ERROR_CHECK(gpio_isr_handler_add((gpio_num_t)config->s_gpio_number, _zh_encoder_button_isr_handler, handle) == ESP_OK, ESP_FAIL,
+                           ZH_ERROR_CHECK(gpio_reset_pin((gpio_num_t)config->s_gpio_number) == ESP_OK, ESP_FAIL, NULL, "Reset GPIO failed."), "Interrupt initialization failed.");
+            handle->s_gpio_status = gpio_get_level((gpio_num_t)config->s_gpio_number);
+        }
+    }
+    handle->z_gpio_number = config->z_gpio_number;
+    if (config->z_gpio_number != GPIO_NUM_MAX && config->backend != ZH_ENCODER_BACKEND_REPLAY)
     {
         gpio_config_t pin_config = {
             .mode = GPIO_MODE_INPUT,
             .pull_up_en = (config->pullup == true) ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE,
-            .pin_bit_mask = (1ULL << config->s_gpio_number),
-            .intr_type = GPIO_INTR_ANYEDGE};
-        ZH_ERROR_CHECK(gpio_config(&pin_config) == ESP_OK, ESP_FAIL, NULL, "GPIO initialization failed.");
-        esp_err_t err = gpio_install_isr_service(ESP_INTR_FLAG_LOWMED);
-        ZH_ERROR_CHECK(err == ESP_OK || err == ESP_ERR_INVALID_STATE, ESP_FAIL,
-                       ZH_ERROR_CHECK(gpio_reset_pin((gpio_num_t)config->s_gpio_number) == ESP_OK, ESP_FAIL, NULL, "Reset GPIO failed."), "Failed install isr service.");
-        ZH_ERROR_CHECK(gpio_isr_handler_add((gpio_num_t)config->s_gpio_number, _zh_encoder_button_isr_handler, handle) == ESP_OK, ESP_FAIL,
-                       ZH_ERROR_CHECK(gpio_reset_pin((gpio_num_t)config->s_gpio_number) == ESP_OK, ESP_FAIL, NULL, "Reset GPIO failed."), "Interrupt initialization failed.");
-        handle->s_gpio_number = config->s_gpio_number;
-        handle->s_gpio_debounce_time = config->s_gpio_debounce_time;
-        handle->s_gpio_status = gpio_get_level((gpio_num_t)config->s_gpio_number);
+            .pin_bit_mask = (1ULL << config->z_gpio_number),
+            .intr_type = (config->index_active_low == true) ? GPIO_INTR_NEGEDGE : GPIO_INTR_POSEDGE};
+        esp_err_t err = gpio_config(&pin_config);
+        if (err == ESP_OK)
+        {
+            err = gpio_install_isr_service(ESP_INTR_FLAG_LOWMED);
+            err = (err == ESP_ERR_INVALID_STATE) ? ESP_OK : err;
+        }
+        if (err == ESP_OK)
+        {
+            err = gpio_isr_handler_add((gpio_num_t)config->z_gpio_number, _zh_encoder_index_isr_handler, handle);
+        }
+        ZH_ERROR_CHECK(err == ESP_OK, ESP_FAIL,
+                       gpio_reset_pin((gpio_num_t)config->z_gpio_number);
+                       if (config->s_gpio_number != GPIO_NUM_MAX) {
+                           gpio_isr_handler_remove((gpio_num_t)config->s_gpio_number);
+                           gpio_reset_pin((gpio_num_t)config->s_gpio_number);
+                       },
+                       "Index interrupt initialization failed.");
     }
     return ESP_OK;
 }
 
-static esp_err_t _zh_encoder_resources_init(const zh_encoder_init_config_t *config)
+static esp_err_t _zh_encoder_task_init(const zh_encoder_init_config_t *config, zh_encoder_handle_t *handle)
 {
-    if (_encoder_counter == 0)
+    zh_encoder_task_group_t *task_group = &_task_group[config->task_group];
+    if (task_group->task_handle == NULL)
     {
-        _queue_handle = xQueueCreate(config->queue_size, sizeof(zh_encoder_queue_t));
-        ZH_ERROR_CHECK(_queue_handle != NULL, ESP_FAIL, NULL, "Failed to create queue.");
+        esp_timer_create_args_t timer_config = {
+            .callback = _zh_encoder_deadline_timer_handler,
+            .arg = task_group,
+            .name = "zh_encoder_deadline",
+        };
+        ZH_ERROR_CHECK(esp_timer_create(&timer_config, &task_group->deadline_timer) == ESP_OK, ESP_FAIL, NULL, "Failed to create deadline timer.");
+        StackType_t *task_stack = config->task_stack;
+        StaticTask_t *task_tcb = config->task_tcb;
+#ifdef CONFIG_ZH_ENCODER_STATIC_ALLOCATION
+        if (task_stack == NULL)
+        {
+            task_stack = _task_stack[config->task_group];
+            task_tcb = &_task_tcb[config->task_group];
+        }
+#endif
+        if (task_stack != NULL)
+        {
+            task_group->task_handle = xTaskCreateStaticPinnedToCore(&_zh_encoder_isr_processing_task, "zh_encoder_isr_processing", config->stack_size, (void *)(uintptr_t)config->task_group, config->task_priority,
+                                                                    task_stack, task_tcb, (config->task_core < 0) ? tskNO_AFFINITY : config->task_core);
+            ZH_ERROR_CHECK(task_group->task_handle != NULL, ESP_FAIL, esp_timer_delete(task_group->deadline_timer), "Failed to create isr processing task.");
+        }
+#ifndef CONFIG_ZH_ENCODER_STATIC_ALLOCATION
+        else
+        {
+            ZH_ERROR_CHECK(xTaskCreatePinnedToCore(&_zh_encoder_isr_processing_task, "zh_encoder_isr_processing", config->stack_size, (void *)(uintptr_t)config->task_group, config->task_priority,
+                                                   &task_group->task_handle, (config->task_core < 0) ? tskNO_AFFINITY : config->task_core) == pdPASS,
+                           ESP_FAIL, esp_timer_delete(task_group->deadline_timer), "Failed to create isr processing task.");
+        }
+#endif
+        task_group->task_priority = config->task_priority;
+        task_group->stack_size = config->stack_size;
+        task_group->queue_size = config->queue_size;
+        task_group->task_core = config->task_core;
+        if (config->task_group == 0)
+        {
+            zh_encoder = task_group->task_handle;
+        }
     }
+    handle->task_handle = task_group->task_handle;
     return ESP_OK;
 }
 
-static esp_err_t _zh_encoder_task_init(const zh_encoder_init_config_t *config)
+static void _zh_encoder_task_deinit(zh_encoder_handle_t *handle)
 {
-    if (_encoder_counter == 0)
+    zh_encoder_task_group_t *task_group = &_task_group[handle->task_group];
+    if (task_group->encoder_counter == 0 && task_group->task_handle != NULL)
     {
-        ZH_ERROR_CHECK(xTaskCreatePinnedToCore(&_zh_encoder_isr_processing_task, "zh_encoder_isr_processing", config->stack_size, NULL, config->task_priority, &zh_encoder, tskNO_AFFINITY) == pdPASS,
-                       ESP_FAIL, NULL, "Failed to create isr processing task.");
-    }
+        TaskHandle_t task_handle = task_group->task_handle;
+        __atomic_store_n(&task_group->task_handle, NULL, __ATOMIC_RELEASE);
+        esp_timer_stop(task_group->deadline_timer);
+        vTaskDelete(task_handle);
+        esp_timer_stop(task_group->deadline_timer);
+        esp_timer_delete(task_group->deadline_timer);
+        task_group->deadline_timer = NULL;
+        if (handle->task_group == 0)
+        {
+            zh_encoder = NULL;
+        }
+    }
+}
+
+static void _zh_encoder_task_sync(const zh_encoder_handle_t *handle)
+{
+    zh_encoder_task_group_t *task_group = &_task_group[handle->task_group];
+    if (task_group->task_handle == NULL || task_group->task_handle == xTaskGetCurrentTaskHandle())
+    {
+        return;
+    }
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    uint32_t pass_sequence = __atomic_load_n(&task_group->pass_sequence, __ATOMIC_SEQ_CST);
+    while ((pass_sequence & 1) != 0 && __atomic_load_n(&task_group->pass_sequence, __ATOMIC_ACQUIRE) == pass_sequence)
+    {
+        vTaskDelay(1);
+    }
+}
+
+static esp_err_t _zh_encoder_counter_init(const zh_encoder_init_config_t *config, zh_encoder_handle_t *handle)
+{
+    if (config->counter_mode == true)
+    {
+        esp_timer_create_args_t timer_config = {
+            .callback = _zh_encoder_counter_timer_handler,
+            .arg = handle,
+            .name = "zh_encoder_counter",
+            .skip_unhandled_events = true,
+        };
+        ZH_ERROR_CHECK(esp_timer_create(&timer_config, &handle->counter_timer_handle) == ESP_OK, ESP_FAIL, NULL, "Failed to create counter timer.");
+        ZH_ERROR_CHECK(esp_timer_start_periodic(handle->counter_timer_handle, config->counter_event_period * 1000ULL) == ESP_OK, ESP_FAIL,
+                       esp_timer_delete(handle->counter_timer_handle), "Failed to start counter timer.");
+    }
     return ESP_OK;
 }
 
-static bool IRAM_ATTR _zh_encoder_isr_handler(pcnt_unit_handle_t unit, const pcnt_watch_event_data_t *edata, void *user_ctx)
+static bool ZH_ENCODER_ISR_ATTR _zh_encoder_position_update(zh_encoder_handle_t *handle, int steps, int64_t step_time, int64_t *prev_ticks, int64_t *ticks)
 {
-    zh_encoder_handle_t *encoder_handle = (zh_encoder_handle_t *)user_ctx;
-    zh_encoder_queue_t encoder_queue = {0};
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    esp_err_t err = pcnt_unit_clear_count(unit);
-    encoder_queue.watch_point_value = edata->watch_point_value;
-    encoder_queue.handle = encoder_handle;
+    portENTER_CRITICAL_SAFE(&_spinlock);
+    _zh_encoder_state_write_begin();
+    *prev_ticks = handle->encoder_ticks;
+    *ticks = _zh_encoder_ticks_limit(handle, handle->encoder_ticks + steps);
+    bool is_value_changed = (*ticks != *prev_ticks);
+    handle->encoder_ticks = *ticks;
+    handle->encoder_step_time = step_time;
+    handle->encoder_direction = (steps > 0) ? ZH_ENCODER_DIRECTION_CW : ZH_ENCODER_DIRECTION_CCW;
+    _zh_encoder_state_write_end();
+    portEXIT_CRITICAL_SAFE(&_spinlock);
+    return is_value_changed;
+}
+
+static int64_t _zh_encoder_ticks_get(const zh_encoder_handle_t *handle)
+{
+    taskENTER_CRITICAL(&_spinlock);
+    int64_t encoder_ticks = handle->encoder_ticks;
+    taskEXIT_CRITICAL(&_spinlock);
+    return encoder_ticks;
+}
+
+static void _zh_encoder_range_set(zh_encoder_handle_t *handle, float min, float max, float step, zh_encoder_reinit_mode_t mode, int steps)
+{
+    double position = _zh_encoder_ticks_to_position(handle, _zh_encoder_ticks_limit(handle, handle->encoder_ticks + steps));
+    double prev_min = handle->encoder_min_value;
+    double prev_max = handle->encoder_max_value;
+    double origin = ((double)min + max) / 2;
+    if (mode == ZH_ENCODER_REINIT_REMAP)
+    {
+        origin = min + (position - prev_min) / (prev_max - prev_min) * ((double)max - min);
+        origin = min + round((origin - min) / step) * step;
+    }
+    else if (mode == ZH_ENCODER_REINIT_CLAMP)
+    {
+        origin = position;
+    }
+    if (origin > max)
+    {
+        origin = max;
+    }
+    if (origin < min)
+    {
+        origin = min;
+    }
+    handle->encoder_min_value = min;
+    handle->encoder_max_value = max;
+    handle->encoder_step = step;
+    _zh_encoder_origin_set(handle, origin);
+}
+
+static void _zh_encoder_origin_set(zh_encoder_handle_t *handle, double origin)
+{
+    handle->encoder_origin = origin;
+    handle->encoder_ticks = 0;
+    ++handle->origin_sequence;
+    handle->encoder_max_ticks = (int64_t)ceil((handle->encoder_max_value - origin) / handle->encoder_step - 1e-6);
+    handle->encoder_min_ticks = (int64_t)floor((handle->encoder_min_value - origin) / handle->encoder_step + 1e-6);
+}
+
+static void ZH_ENCODER_ISR_ATTR _zh_encoder_state_write_begin(void)
+{
+    __atomic_fetch_add(&_state_sequence, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void ZH_ENCODER_ISR_ATTR _zh_encoder_state_write_end(void)
+{
+    __atomic_fetch_add(&_state_sequence, 1, __ATOMIC_RELEASE);
+}
+
+static int _zh_encoder_snapshot_count(const zh_encoder_handle_t *handle)
+{
+    int count = 0;
+    if (handle->counter_mode == true && pcnt_unit_get_count(handle->pcnt_unit_handle, &count) != ESP_OK)
+    {
+        return handle->counter_value;
+    }
+    return count;
+}
+
+static void _zh_encoder_snapshot_get(const zh_encoder_handle_t *handle, zh_encoder_snapshot_t *snapshot)
+{
+    int count = _zh_encoder_snapshot_count(handle);
+    uint32_t sequence = 0;
+    do
+    {
+        sequence = __atomic_load_n(&_state_sequence, __ATOMIC_ACQUIRE);
+        _zh_encoder_snapshot_read(handle, count, snapshot);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((sequence & 1) != 0 || sequence != __atomic_load_n(&_state_sequence, __ATOMIC_RELAXED));
+}
+
+static void _zh_encoder_snapshot_read(const zh_encoder_handle_t *handle, int count, zh_encoder_snapshot_t *snapshot)
+{
+    int64_t encoder_ticks = handle->encoder_ticks;
+    if (handle->counter_mode == true)
+    {
+        encoder_ticks = _zh_encoder_ticks_limit(handle, encoder_ticks + (count - handle->counter_value) / handle->counts_per_step);
+    }
+    snapshot->encoder_ticks = encoder_ticks;
+    snapshot->encoder_position = _zh_encoder_position_calc(handle->encoder_origin, handle->encoder_step, handle->encoder_min_value, handle->encoder_max_value, encoder_ticks);
+    snapshot->encoder_value = _zh_encoder_mapping_calc(handle, snapshot->encoder_position);
+    snapshot->step_time = handle->encoder_step_time;
+    snapshot->direction = handle->encoder_direction;
+    snapshot->encoder_number = handle->encoder_number;
+    snapshot->button_status = handle->s_gpio_status;
+}
+
+static float ZH_ENCODER_ISR_ATTR _zh_encoder_position_calc(double origin, float step, float min, float max, int64_t ticks)
+{
+    double encoder_position = origin + (double)ticks * step;
+    if (encoder_position > max)
+    {
+        encoder_position = max;
+    }
+    if (encoder_position < min)
+    {
+        encoder_position = min;
+    }
+    return (float)encoder_position;
+}
+
+static float ZH_ENCODER_ISR_ATTR _zh_encoder_ticks_to_position(const zh_encoder_handle_t *handle, int64_t ticks)
+{
+    return _zh_encoder_position_calc(handle->encoder_origin, handle->encoder_step, handle->encoder_min_value, handle->encoder_max_value, ticks);
+}
+
+static int64_t ZH_ENCODER_ISR_ATTR _zh_encoder_ticks_limit(const zh_encoder_handle_t *handle, int64_t ticks)
+{
+    if (handle->wrap_around == true)
+    {
+        int64_t period = handle->encoder_max_ticks - handle->encoder_min_ticks + 1;
+        int64_t offset = (ticks - handle->encoder_min_ticks) % period;
+        return handle->encoder_min_ticks + ((offset < 0) ? offset + period : offset);
+    }
+    if (ticks > handle->encoder_max_ticks)
+    {
+        return handle->encoder_max_ticks;
+    }
+    if (ticks < handle->encoder_min_ticks)
+    {
+        return handle->encoder_min_ticks;
+    }
+    return ticks;
+}
+
+static void _zh_encoder_profile_build(const zh_encoder_init_config_t *config, zh_encoder_profile_t *profile)
+{
+    profile->encoder_min_value = config->encoder_min_value;
+    profile->encoder_max_value = config->encoder_max_value;
+    profile->encoder_step = config->encoder_step;
+    profile->mapping = config->mapping;
+    profile->mapping_table_size = (config->mapping == ZH_ENCODER_MAPPING_TABLE) ? config->mapping_table_size : 0;
+    memcpy(profile->mapping_table, config->mapping_table, sizeof(profile->mapping_table));
+    memset(profile->mapping_lut, 0, sizeof(profile->mapping_lut));
+    if (config->mapping != ZH_ENCODER_MAPPING_LOG && config->mapping != ZH_ENCODER_MAPPING_EXP)
+    {
+        return;
+    }
+    double curvature = config->mapping_curvature;
+    double range = (double)config->mapping_max_value - config->mapping_min_value;
+    for (uint8_t i = 0; i < ZH_ENCODER_MAPPING_LUT_SIZE; ++i)
+    {
+        double t = (double)i / (ZH_ENCODER_MAPPING_LUT_SIZE - 1);
+        double curve = (config->mapping == ZH_ENCODER_MAPPING_LOG) ? log1p(curvature * t) / log1p(curvature) : expm1(curvature * t) / expm1(curvature);
+        profile->mapping_lut[i] = (float)(config->mapping_min_value + range * curve);
+    }
+}
+
+static float _zh_encoder_mapping_calc(const zh_encoder_handle_t *handle, float position)
+{
+    const zh_encoder_profile_t *profile = handle->mapping_profile;
+    if (profile->mapping == ZH_ENCODER_MAPPING_LOG || profile->mapping == ZH_ENCODER_MAPPING_EXP)
+    {
+        float index = (position - handle->encoder_min_value) / (handle->encoder_max_value - handle->encoder_min_value) * (ZH_ENCODER_MAPPING_LUT_SIZE - 1);
+        if (index <= 0)
+        {
+            return profile->mapping_lut[0];
+        }
+        if (index >= ZH_ENCODER_MAPPING_LUT_SIZE - 1)
+        {
+            return profile->mapping_lut[ZH_ENCODER_MAPPING_LUT_SIZE - 1];
+        }
+        uint8_t i = (uint8_t)index;
+        return profile->mapping_lut[i] + (profile->mapping_lut[i + 1] - profile->mapping_lut[i]) * (index - i);
+    }
+    if (profile->mapping == ZH_ENCODER_MAPPING_TABLE)
+    {
+        const zh_encoder_mapping_point_t *table = profile->mapping_table;
+        if (position <= table[0].position)
+        {
+            return table[0].value;
+        }
+        for (uint8_t i = 1; i < profile->mapping_table_size; ++i)
+        {
+            if (position <= table[i].position)
+            {
+                return table[i - 1].value + (table[i].value - table[i - 1].value) * (position - table[i - 1].position) / (table[i].position - table[i - 1].position);
+            }
+        }
+        return table[profile->mapping_table_size - 1].value;
+    }
+    return position;
+}
+
+static int _zh_encoder_counter_steps(zh_encoder_handle_t *handle)
+{
+    if (handle->counter_mode == false)
+    {
+        return 0;
+    }
+    int count = 0;
+    if (pcnt_unit_get_count(handle->pcnt_unit_handle, &count) != ESP_OK)
+    {
+        return 0;
+    }
+    taskENTER_CRITICAL(&_spinlock);
+    _zh_encoder_state_write_begin();
+    int steps = (count - handle->counter_value) / handle->counts_per_step;
+    handle->counter_value += steps * handle->counts_per_step;
+    _zh_encoder_state_write_end();
+    taskEXIT_CRITICAL(&_spinlock);
+    return steps;
+}
+
+static int ZH_ENCODER_ISR_ATTR _zh_encoder_acceleration(zh_encoder_handle_t *handle, int steps, uint32_t step_time)
+{
+    uint16_t multiplier = 1;
+    int8_t direction = (steps > 0) ? ZH_ENCODER_DIRECTION_CW : ZH_ENCODER_DIRECTION_CCW;
+    uint32_t interval = step_time - handle->acceleration_prev_time;
+    if (handle->acceleration[0].multiplier != 0 && direction == handle->acceleration_direction && interval != 0)
+    {
+        uint32_t step_count = (steps > 0) ? steps : -steps;
+        uint64_t step_rate = (uint64_t)step_count * 1000000ULL / interval;
+        for (uint8_t i = 0; i < ZH_ENCODER_ACCELERATION_TABLE_SIZE && handle->acceleration[i].multiplier != 0; ++i)
+        {
+            if (step_rate >= handle->acceleration[i].step_rate)
+            {
+                multiplier = handle->acceleration[i].multiplier;
+            }
+        }
+    }
+    handle->acceleration_prev_time = step_time;
+    handle->acceleration_direction = direction;
+    return steps * multiplier;
+}
+
+static void _zh_encoder_velocity_update(zh_encoder_handle_t *handle, int steps, uint32_t step_time)
+{
+    int8_t direction = (steps > 0) ? ZH_ENCODER_DIRECTION_CW : ZH_ENCODER_DIRECTION_CCW;
+    if (direction != handle->velocity_direction)
+    {
+        handle->velocity_direction = direction;
+        handle->velocity_window_time = step_time;
+        handle->velocity_window_steps = 0;
+        handle->velocity_offset = 0;
+        handle->velocity = 0;
+        handle->velocity_step_time = step_time;
+        return;
+    }
+    handle->velocity_window_steps += steps;
+    uint32_t interval = step_time - handle->velocity_window_time;
+    if (interval != 0 && interval >= handle->velocity_window * 1000UL)
+    {
+        float measured_velocity = handle->velocity_window_steps * 1000000.0f / interval;
+        if (handle->velocity_alpha > 0)
+        {
+            float interval_s = interval / 1000000.0f;
+            float offset = handle->velocity_offset + handle->velocity * interval_s - handle->velocity_window_steps;
+            handle->velocity_offset = offset * (1 - handle->velocity_alpha);
+            measured_velocity = handle->velocity - handle->velocity_beta * offset / interval_s;
+        }
+        handle->velocity = measured_velocity;
+        handle->velocity_window_time = step_time;
+        handle->velocity_window_steps = 0;
+    }
+    handle->velocity_step_time = step_time;
+}
+
+static float _zh_encoder_velocity_get(const zh_encoder_handle_t *handle, int64_t current_time)
+{
+    float velocity = handle->velocity;
+    uint32_t interval = (uint32_t)current_time - handle->velocity_step_time;
+    if (interval != 0)
+    {
+        float max_velocity = 1000000.0f / interval;
+        if (velocity > max_velocity)
+        {
+            velocity = max_velocity;
+        }
+        else if (velocity < -max_velocity)
+        {
+            velocity = -max_velocity;
+        }
+    }
+    return velocity * handle->encoder_step;
+}
+
+static void _zh_encoder_metrics_begin(zh_encoder_handle_t *handle)
+{
+    __atomic_fetch_add(&handle->metrics_sequence, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void _zh_encoder_metrics_end(zh_encoder_handle_t *handle)
+{
+    __atomic_fetch_add(&handle->metrics_sequence, 1, __ATOMIC_RELEASE);
+}
+
+static uint8_t _zh_encoder_latency_bucket(uint32_t latency)
+{
+    if (latency <= 1)
+    {
+        return 0;
+    }
+    uint8_t bucket = 31 - __builtin_clz(latency);
+    return (bucket < ZH_ENCODER_LATENCY_BUCKETS) ? bucket : ZH_ENCODER_LATENCY_BUCKETS - 1;
+}
+
+static void _zh_encoder_batch_post(uint8_t task_group)
+{
+    uint32_t process_time = (uint32_t)esp_timer_get_time();
+    zh_encoder_batch_event_on_isr_t batch_data = {0};
+    uint16_t event_timeout = UINT16_MAX;
+    esp_event_loop_handle_t event_loop = NULL;
+    for (uint8_t i = 0; i < ZH_ENCODER_MAX_QUANTITY; ++i)
+    {
+        zh_encoder_handle_t *encoder_handle = _encoder_handle_matrix[i];
+        if (encoder_handle == NULL || encoder_handle->task_group != task_group || encoder_handle->batch_step_count == 0)
+        {
+            continue;
+        }
+        if (encoder_handle->event_timeout < event_timeout)
+        {
+            event_timeout = encoder_handle->event_timeout;
+        }
+        event_loop = encoder_handle->event_loop;
+        zh_encoder_batch_item_t *item = &batch_data.encoder_data[batch_data.encoder_quantity++];
+        item->encoder_number = encoder_handle->encoder_number;
+        item->encoder_position = _zh_encoder_ticks_to_position(encoder_handle, _zh_encoder_ticks_get(encoder_handle));
+        item->encoder_value = _zh_encoder_mapping_calc(encoder_handle, item->encoder_position);
+        item->encoder_delta = item->encoder_position - _zh_encoder_ticks_to_position(encoder_handle, encoder_handle->batch_start_ticks);
+        item->encoder_velocity = _zh_encoder_velocity_get(encoder_handle, esp_timer_get_time());
+        item->step_count = encoder_handle->batch_step_count;
+        encoder_handle->batch_step_count = 0;
+    }
+    if (batch_data.encoder_quantity == 0)
+    {
+        return;
+    }
+    esp_err_t err = _zh_encoder_event_send(event_loop, ZH_ENCODER_BATCH_EVENT, &batch_data, sizeof(zh_encoder_batch_event_on_isr_t), event_timeout);
+    uint8_t post_latency_bucket = _zh_encoder_latency_bucket((uint32_t)esp_timer_get_time() - process_time);
+    for (uint8_t i = 0; i < ZH_ENCODER_MAX_QUANTITY; ++i)
+    {
+        zh_encoder_handle_t *encoder_handle = _encoder_handle_matrix[i];
+        if (encoder_handle == NULL || encoder_handle->task_group != task_group || encoder_handle->batch_mode == false)
+        {
+            continue;
+        }
+        for (uint8_t j = 0; j < batch_data.encoder_quantity; ++j)
+        {
+            if (batch_data.encoder_data[j].encoder_number == encoder_handle->encoder_number)
+            {
+                _zh_encoder_metrics_begin(encoder_handle);
+                if (err != ESP_OK)
+                {
+                    ++encoder_handle->metrics.event_post_error;
+                }
+                else
+                {
+                    ++encoder_handle->metrics.event_post_count;
+                    ++encoder_handle->metrics.post_latency[post_latency_bucket];
+                }
+                _zh_encoder_metrics_end(encoder_handle);
+            }
+        }
+    }
     if (err != ESP_OK)
     {
+        __atomic_fetch_add(&_stats.event_post_error, 1, __ATOMIC_RELAXED);
+        ZH_LOGE("Encoder isr processing failed. Failed to post batch event.", err);
+    }
+}
+
+static bool ZH_ENCODER_ISR_ATTR _zh_encoder_isr_handler(pcnt_unit_handle_t unit, const pcnt_watch_event_data_t *edata, void *user_ctx)
+{
+    if (pcnt_unit_clear_count(unit) != ESP_OK)
+    {
+        __atomic_fetch_add(&((zh_encoder_handle_t *)user_ctx)->metrics.step_drop_count, 1, __ATOMIC_RELAXED);
+        _zh_encoder_trace_write((uint32_t)esp_timer_get_time(), ((zh_encoder_handle_t *)user_ctx)->encoder_number, ZH_ENCODER_TRACE_DROP, 1);
         return false;
     }
-    if (xQueueSendFromISR(_queue_handle, &encoder_queue, &xHigherPriorityTaskWoken) != pdTRUE)
+    return _zh_encoder_step_isr((zh_encoder_handle_t *)user_ctx, (edata->watch_point_value > 0) ? ZH_ENCODER_DIRECTION_CW : ZH_ENCODER_DIRECTION_CCW);
+}
+
+static bool ZH_ENCODER_ISR_ATTR _zh_encoder_counter_isr_handler(pcnt_unit_handle_t unit, const pcnt_watch_event_data_t *edata, void *user_ctx)
+{
+    (void)unit;
+    (void)edata;
+    (void)user_ctx;
+    return false;
+}
+
+static bool ZH_ENCODER_ISR_ATTR _zh_encoder_step_isr(zh_encoder_handle_t *handle, int steps)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    uint32_t current_time = (uint32_t)esp_timer_get_time();
+    _zh_encoder_trace_write(current_time, handle->encoder_number, ZH_ENCODER_TRACE_STEP, steps);
+    if (_zh_encoder_step_apply(handle, steps, current_time) == false)
     {
-        ++_stats.queue_overflow_error;
+        return false;
     }
+    vTaskNotifyGiveFromISR(handle->task_handle, &xHigherPriorityTaskWoken);
     if (xHigherPriorityTaskWoken == pdTRUE)
     {
         return true;
@@ -363,82 +1608,816 @@ static bool IRAM_ATTR _zh_encoder_isr_handler(pcnt_unit_handle_t unit, const pcn
     return false;
 }
 
-static void IRAM_ATTR _zh_encoder_isr_processing_task(void *pvParameter)
+static bool ZH_ENCODER_ISR_ATTR _zh_encoder_step_apply(zh_encoder_handle_t *handle, int steps, uint32_t current_time)
 {
-    zh_encoder_queue_t encoder_queue = {0};
-    bool is_value_changed = false;
-    while (xQueueReceive(_queue_handle, &encoder_queue, portMAX_DELAY) == pdTRUE)
+    if (handle->hysteresis_count > 1 || handle->hysteresis_window != 0)
+    {
+        steps = _zh_encoder_hysteresis(handle, steps, current_time);
+        if (steps == 0)
+        {
+            return false;
+        }
+    }
+    uint32_t no_pending_time = 0;
+    __atomic_compare_exchange_n(&handle->pending_time, &no_pending_time, (current_time != 0) ? current_time : 1, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    __atomic_store_n(&handle->step_time, current_time, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&handle->metrics.step_count, (steps > 0) ? steps : -steps, __ATOMIC_RELAXED);
+    if (handle->callback_in_isr == true)
     {
-        zh_encoder_handle_t *encoder_handle = encoder_queue.handle;
-        switch (encoder_queue.watch_point_value)
+        int64_t prev_ticks = 0;
+        int64_t encoder_ticks = 0;
+        if (_zh_encoder_position_update(handle, _zh_encoder_acceleration(handle, steps, current_time), esp_timer_get_time(), &prev_ticks, &encoder_ticks) == false)
         {
-        case ZH_ENCODER_DIRECTION_CW:
-            if (encoder_handle->encoder_position < encoder_handle->encoder_max_value)
+            return false;
+        }
+        int32_t ticks_delta = (int32_t)(encoder_ticks - prev_ticks);
+        handle->isr_callback(handle->encoder_number, encoder_ticks, ticks_delta, handle->callback_arg);
+        __atomic_fetch_add(&handle->isr_ticks_delta, ticks_delta, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        __atomic_fetch_add(&handle->pending_steps, steps, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&handle->index_step_total, steps, __ATOMIC_RELAXED);
+    }
+    return true;
+}
+
+static void ZH_ENCODER_ISR_ATTR _zh_encoder_trace_write(uint32_t time, uint8_t encoder_number, zh_encoder_trace_type_t type, int16_t value)
+{
+    if (__atomic_load_n(&_trace_enabled, __ATOMIC_RELAXED) == false)
+    {
+        return;
+    }
+    portENTER_CRITICAL_SAFE(&_spinlock);
+    if (_trace_enabled == true)
+    {
+        zh_encoder_trace_record_t *record = &_trace_buffer[_trace_head++ % _trace_size];
+        record->time = time;
+        record->encoder_number = encoder_number;
+        record->type = type;
+        record->value = value;
+    }
+    portEXIT_CRITICAL_SAFE(&_spinlock);
+}
+
+static int ZH_ENCODER_ISR_ATTR _zh_encoder_hysteresis(zh_encoder_handle_t *handle, int steps, uint32_t step_time)
+{
+    int8_t direction = (steps > 0) ? ZH_ENCODER_DIRECTION_CW : ZH_ENCODER_DIRECTION_CCW;
+    uint16_t step_count = (steps > 0) ? steps : -steps;
+    if (handle->hysteresis_direction == 0 || direction == handle->hysteresis_direction)
+    {
+        if (handle->hysteresis_direction != 0 && handle->hysteresis_reversals != 0)
+        {
+            uint16_t cancelled = (step_count < handle->hysteresis_reversals) ? step_count : handle->hysteresis_reversals;
+            handle->hysteresis_reversals -= cancelled;
+            step_count -= cancelled;
+            __atomic_fetch_add(&handle->metrics.step_reject_count, cancelled * 2, __ATOMIC_RELAXED);
+            if (step_count == 0)
             {
-                encoder_handle->encoder_position = encoder_handle->encoder_position + encoder_handle->encoder_step;
-                if (encoder_handle->encoder_position > encoder_handle->encoder_max_value)
+                return 0;
+            }
+        }
+        handle->hysteresis_direction = direction;
+        handle->hysteresis_time = step_time;
+        return step_count * direction;
+    }
+    handle->hysteresis_reversals += step_count;
+    if (handle->hysteresis_reversals < handle->hysteresis_count || step_time - handle->hysteresis_time < handle->hysteresis_window * 1000UL)
+    {
+        return 0;
+    }
+    step_count = handle->hysteresis_reversals;
+    handle->hysteresis_reversals = 0;
+    handle->hysteresis_direction = direction;
+    handle->hysteresis_time = step_time;
+    return step_count * direction;
+}
+
+static void ZH_ENCODER_TASK_ATTR _zh_encoder_isr_processing_task(void *pvParameter)
+{
+    uint8_t task_group = (uint8_t)(uintptr_t)pvParameter;
+    esp_timer_handle_t deadline_timer = _task_group[task_group].deadline_timer;
+    TickType_t wait_time = portMAX_DELAY;
+    int64_t batch_frame_end = 0;
+    int64_t timer_deadline = 0;
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, wait_time);
+        __atomic_fetch_add(&_task_group[task_group].pass_sequence, 1, __ATOMIC_SEQ_CST);
+        int64_t next_deadline = 0;
+        bool is_commit_required = false;
+        for (uint8_t i = 0; i < ZH_ENCODER_MAX_QUANTITY; ++i)
+        {
+            zh_encoder_handle_t *encoder_handle = _encoder_handle_matrix[i];
+            if (encoder_handle == NULL || encoder_handle->task_group != task_group)
+            {
+                continue;
+            }
+            _zh_encoder_process(encoder_handle, &batch_frame_end);
+            if (encoder_handle->z_gpio_number != GPIO_NUM_MAX)
+            {
+                _zh_encoder_index_process(encoder_handle);
+            }
+            if (encoder_handle->event_pending == true)
+            {
+                int64_t event_deadline = _zh_encoder_event_post(encoder_handle);
+                if (event_deadline != 0 && (next_deadline == 0 || event_deadline < next_deadline))
                 {
-                    encoder_handle->encoder_position = encoder_handle->encoder_max_value;
+                    next_deadline = event_deadline;
                 }
-                is_value_changed = true;
             }
-            break;
-        case ZH_ENCODER_DIRECTION_CCW:
-            if (encoder_handle->encoder_position > encoder_handle->encoder_min_value)
+            if (encoder_handle->s_gpio_number != GPIO_NUM_MAX)
             {
-                encoder_handle->encoder_position = encoder_handle->encoder_position - encoder_handle->encoder_step;
-                if (encoder_handle->encoder_position < encoder_handle->encoder_min_value)
+                int64_t button_deadline = _zh_encoder_button_process(encoder_handle);
+                if (button_deadline != 0 && (next_deadline == 0 || button_deadline < next_deadline))
                 {
-                    encoder_handle->encoder_position = encoder_handle->encoder_min_value;
+                    next_deadline = button_deadline;
+                }
+            }
+            if (encoder_handle->persistence == true)
+            {
+                int64_t persistence_deadline = _zh_encoder_persistence_process(encoder_handle, &is_commit_required);
+                if (persistence_deadline != 0 && (next_deadline == 0 || persistence_deadline < next_deadline))
+                {
+                    next_deadline = persistence_deadline;
                 }
-                is_value_changed = true;
             }
-            break;
-        default:
-            break;
         }
-        if (is_value_changed == true)
+        if (is_commit_required == true && nvs_commit(_nvs_handle) != ESP_OK)
         {
-            is_value_changed = false;
-            zh_encoder_event_on_isr_t encoder_data = {0};
-            encoder_data.encoder_number = encoder_handle->encoder_number;
-            encoder_data.encoder_position = encoder_handle->encoder_position;
-            esp_err_t err = esp_event_post(ZH_ENCODER, ZH_ENCODER_EVENT, &encoder_data, sizeof(zh_encoder_event_on_isr_t), 1000 / portTICK_PERIOD_MS);
-            if (err != ESP_OK)
+            ZH_LOGE("Encoder isr processing failed. NVS commit failed.", ESP_FAIL);
+        }
+        if (batch_frame_end != 0 && batch_frame_end <= esp_timer_get_time())
+        {
+            _zh_encoder_batch_post(task_group);
+            batch_frame_end = 0;
+        }
+        __atomic_fetch_add(&_task_group[task_group].pass_sequence, 1, __ATOMIC_RELEASE);
+        if (batch_frame_end != 0 && (next_deadline == 0 || batch_frame_end < next_deadline))
+        {
+            next_deadline = batch_frame_end;
+        }
+        wait_time = portMAX_DELAY;
+        if (next_deadline != 0 && next_deadline <= esp_timer_get_time())
+        {
+            wait_time = 0;
+        }
+        else if (next_deadline != timer_deadline)
+        {
+            esp_timer_stop(deadline_timer);
+            timer_deadline = 0;
+            if (next_deadline != 0)
             {
-                ++_stats.event_post_error;
-                ZH_LOGE("Encoder isr processing failed. Failed to post interrupt event.", err);
+                int64_t time_left = next_deadline - esp_timer_get_time();
+                if (time_left > 0 && esp_timer_start_once(deadline_timer, time_left) == ESP_OK)
+                {
+                    timer_deadline = next_deadline;
+                }
+                else
+                {
+                    wait_time = 0;
+                }
             }
         }
-        _stats.min_stack_size = (uint32_t)uxTaskGetStackHighWaterMark(NULL);
+        uint32_t min_stack_size = (uint32_t)uxTaskGetStackHighWaterMark(NULL);
+        if (_stats.min_stack_size == 0 || min_stack_size < _stats.min_stack_size)
+        {
+            _stats.min_stack_size = min_stack_size;
+        }
     }
     vTaskDelete(NULL);
 }
 
-static void IRAM_ATTR _zh_encoder_button_isr_handler(void *arg)
+static void _zh_encoder_process(zh_encoder_handle_t *handle, int64_t *batch_frame_end)
+{
+    int steps = 0;
+    uint32_t step_time = 0;
+    if (handle->counter_mode == true)
+    {
+        if (__atomic_exchange_n(&handle->counter_update_request, false, __ATOMIC_RELAXED) == true)
+        {
+            steps = _zh_encoder_counter_steps(handle);
+            step_time = (uint32_t)esp_timer_get_time();
+        }
+    }
+    else if (handle->callback_in_isr == true)
+    {
+        steps = __atomic_exchange_n(&handle->isr_ticks_delta, 0, __ATOMIC_RELAXED);
+        step_time = __atomic_load_n(&handle->step_time, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        steps = __atomic_exchange_n(&handle->pending_steps, 0, __ATOMIC_RELAXED);
+        step_time = __atomic_load_n(&handle->step_time, __ATOMIC_RELAXED);
+        handle->index_step_applied += steps;
+    }
+    if (steps == 0)
+    {
+        return;
+    }
+    _zh_encoder_metrics_begin(handle);
+    uint32_t pending_steps = (steps > 0) ? steps : -steps;
+    if (pending_steps > handle->metrics.pending_steps_max)
+    {
+        handle->metrics.pending_steps_max = pending_steps;
+    }
+    uint32_t pending_time = __atomic_exchange_n(&handle->pending_time, 0, __ATOMIC_RELAXED);
+    uint32_t process_time = (uint32_t)esp_timer_get_time();
+    if (pending_time != 0)
+    {
+        ++handle->metrics.process_latency[_zh_encoder_latency_bucket(process_time - pending_time)];
+    }
+    _zh_encoder_metrics_end(handle);
+    _zh_encoder_velocity_update(handle, steps, step_time);
+    int64_t prev_ticks = 0;
+    int64_t encoder_ticks = 0;
+    if (handle->callback_in_isr == false)
+    {
+        int64_t current_time = esp_timer_get_time();
+        if (_zh_encoder_position_update(handle, _zh_encoder_acceleration(handle, steps, step_time), current_time - (uint32_t)((uint32_t)current_time - step_time), &prev_ticks, &encoder_ticks) == false)
+        {
+            return;
+        }
+    }
+    else
+    {
+        encoder_ticks = _zh_encoder_ticks_get(handle);
+        prev_ticks = encoder_ticks - steps;
+    }
+    if (handle->callback != NULL)
+    {
+        float encoder_position = _zh_encoder_ticks_to_position(handle, encoder_ticks);
+        handle->callback(handle->encoder_number, encoder_position, encoder_position - _zh_encoder_ticks_to_position(handle, prev_ticks), handle->callback_arg);
+    }
+    if (handle->persistence == true)
+    {
+        __atomic_store_n(&handle->persistence_request, true, __ATOMIC_RELAXED);
+    }
+    _zh_encoder_waiter_notify(handle);
+    if (handle->batch_mode == true)
+    {
+        if (handle->batch_step_count == 0)
+        {
+            handle->batch_start_ticks = prev_ticks;
+        }
+        handle->batch_step_count += (steps > 0) ? steps : -steps;
+        if (*batch_frame_end == 0)
+        {
+            *batch_frame_end = esp_timer_get_time() + _batch_frame_period * 1000LL;
+        }
+        return;
+    }
+    if (handle->event_pending == true)
+    {
+        _zh_encoder_metrics_begin(handle);
+        ++handle->metrics.event_skip_count;
+        _zh_encoder_metrics_end(handle);
+    }
+    handle->event_pending = true;
+}
+
+static int64_t _zh_encoder_event_post(zh_encoder_handle_t *handle)
+{
+    int64_t current_time = esp_timer_get_time();
+    if (handle->event_min_interval != 0 && handle->event_prev_time != 0 && current_time - handle->event_prev_time < handle->event_min_interval * 1000LL)
+    {
+        if (handle->event_coalescing == true)
+        {
+            return handle->event_prev_time + handle->event_min_interval * 1000LL;
+        }
+        handle->event_pending = false;
+        _zh_encoder_metrics_begin(handle);
+        ++handle->metrics.event_skip_count;
+        _zh_encoder_metrics_end(handle);
+        return 0;
+    }
+    zh_encoder_event_on_isr_t encoder_data = {0};
+    encoder_data.encoder_number = handle->encoder_number;
+    encoder_data.encoder_position = _zh_encoder_ticks_to_position(handle, _zh_encoder_ticks_get(handle));
+    encoder_data.encoder_value = _zh_encoder_mapping_calc(handle, encoder_data.encoder_position);
+    encoder_data.encoder_velocity = _zh_encoder_velocity_get(handle, current_time);
+    esp_err_t err = _zh_encoder_event_send(handle->event_loop, ZH_ENCODER_EVENT, &encoder_data, sizeof(zh_encoder_event_on_isr_t), handle->event_timeout);
+    if (err != ESP_OK && handle->event_coalescing == true)
+    {
+        return current_time + ZH_ENCODER_EVENT_RETRY_PERIOD * 1000LL;
+    }
+    handle->event_pending = false;
+    handle->event_prev_time = current_time;
+    _zh_encoder_metrics_begin(handle);
+    if (err != ESP_OK)
+    {
+        ++handle->metrics.event_post_error;
+    }
+    else
+    {
+        ++handle->metrics.event_post_count;
+        ++handle->metrics.post_latency[_zh_encoder_latency_bucket((uint32_t)(esp_timer_get_time() - current_time))];
+    }
+    _zh_encoder_metrics_end(handle);
+    if (err != ESP_OK)
+    {
+        __atomic_fetch_add(&_stats.event_post_error, 1, __ATOMIC_RELAXED);
+        ZH_LOGE("Encoder isr processing failed. Failed to post interrupt event.", err);
+    }
+    return 0;
+}
+
+static esp_err_t _zh_encoder_event_send(esp_event_loop_handle_t event_loop, int32_t event_id, const void *event_data, size_t event_data_size, uint16_t event_timeout)
+{
+    if (event_loop == NULL)
+    {
+        return esp_event_post(ZH_ENCODER, event_id, event_data, event_data_size, pdMS_TO_TICKS(event_timeout));
+    }
+    return esp_event_post_to(event_loop, ZH_ENCODER, event_id, event_data, event_data_size, pdMS_TO_TICKS(event_timeout));
+}
+
+static esp_err_t _zh_encoder_persistence_init(const zh_encoder_init_config_t *config, zh_encoder_handle_t *handle)
+{
+    handle->persistence = config->persistence;
+    handle->persistence_quiet_period = config->persistence_quiet_period;
+    handle->persistence_request = false;
+    handle->persistence_dirty = false;
+    handle->persistence_stored = false;
+    handle->persistence_deadline = 0;
+    if (config->persistence == false)
+    {
+        return ESP_OK;
+    }
+    nvs_handle_t nvs_handle = 0;
+    esp_err_t err = nvs_open(ZH_ENCODER_NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
+    if (err == ESP_ERR_NVS_NOT_FOUND)
+    {
+        return ESP_OK;
+    }
+    ZH_ERROR_CHECK(err == ESP_OK, ESP_FAIL, NULL, "NVS open failed.");
+    char key[NVS_KEY_NAME_MAX_SIZE] = {0};
+    snprintf(key, sizeof(key), "position_%u", handle->encoder_number);
+    uint32_t value = 0;
+    err = nvs_get_u32(nvs_handle, key, &value);
+    nvs_close(nvs_handle);
+    if (err == ESP_ERR_NVS_NOT_FOUND)
+    {
+        return ESP_OK;
+    }
+    ZH_ERROR_CHECK(err == ESP_OK, ESP_FAIL, NULL, "NVS read failed.");
+    float position = 0;
+    memcpy(&position, &value, sizeof(position));
+    if (position >= handle->encoder_min_value && position <= handle->encoder_max_value)
+    {
+        _zh_encoder_origin_set(handle, position);
+    }
+    handle->persistence_value = value;
+    handle->persistence_stored = true;
+    return ESP_OK;
+}
+
+static void _zh_encoder_persistence_request(zh_encoder_handle_t *handle)
+{
+    if (handle->persistence == true)
+    {
+        __atomic_store_n(&handle->persistence_request, true, __ATOMIC_RELAXED);
+        xTaskNotifyGive(handle->task_handle);
+    }
+}
+
+static void _zh_encoder_waiter_notify(const zh_encoder_handle_t *handle)
+{
+    uint32_t slot = 1UL << handle->encoder_index;
+    if ((__atomic_load_n(&_waiter_slot_mask, __ATOMIC_RELAXED) & slot) == 0)
+    {
+        return;
+    }
+    TaskHandle_t task_handle[ZH_ENCODER_MAX_WAITERS] = {NULL};
+    taskENTER_CRITICAL(&_spinlock);
+    for (uint8_t i = 0; i < ZH_ENCODER_MAX_WAITERS; ++i)
+    {
+        if (_waiter[i].task_handle != NULL && (_waiter[i].slot_mask & slot) != 0)
+        {
+            _waiter[i].changed_mask |= slot;
+            task_handle[i] = _waiter[i].task_handle;
+        }
+    }
+    taskEXIT_CRITICAL(&_spinlock);
+    for (uint8_t i = 0; i < ZH_ENCODER_MAX_WAITERS; ++i)
+    {
+        if (task_handle[i] != NULL)
+        {
+            xTaskNotifyGive(task_handle[i]);
+        }
+    }
+}
+
+static void _zh_encoder_waiter_mask_update(void)
+{
+    uint32_t slot_mask = 0;
+    for (uint8_t i = 0; i < ZH_ENCODER_MAX_WAITERS; ++i)
+    {
+        if (_waiter[i].task_handle != NULL)
+        {
+            slot_mask |= _waiter[i].slot_mask;
+        }
+    }
+    _waiter_slot_mask = slot_mask;
+}
+
+static int64_t _zh_encoder_persistence_process(zh_encoder_handle_t *handle, bool *is_commit_required)
+{
+    int64_t current_time = esp_timer_get_time();
+    if (__atomic_exchange_n(&handle->persistence_request, false, __ATOMIC_RELAXED) == true)
+    {
+        if (handle->persistence_dirty == true)
+        {
+            _zh_encoder_metrics_begin(handle);
+            ++handle->metrics.persistence_write_avoided;
+            _zh_encoder_metrics_end(handle);
+        }
+        handle->persistence_dirty = true;
+        handle->persistence_deadline = current_time + handle->persistence_quiet_period * 1000LL;
+    }
+    if (handle->persistence_dirty == false)
+    {
+        return 0;
+    }
+    if (current_time < handle->persistence_deadline)
+    {
+        return handle->persistence_deadline;
+    }
+    handle->persistence_dirty = false;
+    if (_zh_encoder_persistence_write(handle) == true)
+    {
+        *is_commit_required = true;
+    }
+    return 0;
+}
+
+static bool _zh_encoder_persistence_write(zh_encoder_handle_t *handle)
+{
+    float position = _zh_encoder_ticks_to_position(handle, _zh_encoder_ticks_get(handle));
+    uint32_t value = 0;
+    memcpy(&value, &position, sizeof(value));
+    if (handle->persistence_stored == true && value == handle->persistence_value)
+    {
+        _zh_encoder_metrics_begin(handle);
+        ++handle->metrics.persistence_write_avoided;
+        _zh_encoder_metrics_end(handle);
+        return false;
+    }
+    if (_nvs_handle == 0)
+    {
+        nvs_handle_t nvs_handle = 0;
+        esp_err_t err = nvs_open(ZH_ENCODER_NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+        if (err != ESP_OK)
+        {
+            ZH_LOGE("Encoder isr processing failed. NVS open failed.", err);
+            return false;
+        }
+        nvs_handle_t no_nvs_handle = 0;
+        if (__atomic_compare_exchange_n(&_nvs_handle, &no_nvs_handle, nvs_handle, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED) == false)
+        {
+            nvs_close(nvs_handle);
+        }
+    }
+    char key[NVS_KEY_NAME_MAX_SIZE] = {0};
+    snprintf(key, sizeof(key), "position_%u", handle->encoder_number);
+    esp_err_t err = nvs_set_u32(_nvs_handle, key, value);
+    if (err != ESP_OK)
+    {
+        ZH_LOGE("Encoder isr processing failed. NVS write failed.", err);
+        return false;
+    }
+    handle->persistence_value = value;
+    handle->persistence_stored = true;
+    _zh_encoder_metrics_begin(handle);
+    ++handle->metrics.persistence_write_count;
+    _zh_encoder_metrics_end(handle);
+    return true;
+}
+
+static void ZH_ENCODER_ISR_ATTR _zh_encoder_button_isr_handler(void *arg)
 {
     zh_encoder_handle_t *encoder_handle = (zh_encoder_handle_t *)arg;
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    uint64_t _current_us = esp_timer_get_time();
-    if (_current_us - encoder_handle->s_gpio_prev_time >= encoder_handle->s_gpio_debounce_time)
+    uint32_t current_time = (uint32_t)esp_timer_get_time();
+    if (__atomic_load_n(&_trace_enabled, __ATOMIC_RELAXED) == true)
+    {
+        _zh_encoder_trace_write(current_time, encoder_handle->encoder_number, ZH_ENCODER_TRACE_BUTTON, gpio_get_level((gpio_num_t)encoder_handle->s_gpio_number));
+    }
+    __atomic_store_n(&encoder_handle->button_edge_time, current_time, __ATOMIC_RELAXED);
+    __atomic_store_n(&encoder_handle->button_edge_pending, true, __ATOMIC_RELEASE);
+    vTaskNotifyGiveFromISR(encoder_handle->task_handle, &xHigherPriorityTaskWoken);
+    if (xHigherPriorityTaskWoken == pdTRUE)
+    {
+        portYIELD_FROM_ISR();
+    };
+}
+
+static int64_t _zh_encoder_button_process(zh_encoder_handle_t *handle)
+{
+    int64_t current_time = esp_timer_get_time();
+    if (__atomic_exchange_n(&handle->button_edge_pending, false, __ATOMIC_ACQUIRE) == true)
+    {
+        uint32_t edge_time = __atomic_load_n(&handle->button_edge_time, __ATOMIC_RELAXED);
+        handle->s_gpio_prev_time = current_time - (uint32_t)((uint32_t)current_time - edge_time);
+        handle->button_debounce_pending = true;
+    }
+    if (handle->button_debounce_pending == true && current_time >= (int64_t)handle->s_gpio_prev_time + handle->s_gpio_debounce_time)
     {
-        bool s_gpio_status = gpio_get_level((gpio_num_t)encoder_handle->s_gpio_number);
-        if (encoder_handle->s_gpio_status != s_gpio_status)
+        handle->button_debounce_pending = false;
+        bool s_gpio_status = (handle->backend == ZH_ENCODER_BACKEND_REPLAY) ? __atomic_load_n(&handle->s_gpio_replay_level, __ATOMIC_RELAXED) : gpio_get_level((gpio_num_t)handle->s_gpio_number);
+        if (handle->s_gpio_status != s_gpio_status)
         {
-            encoder_handle->s_gpio_status = s_gpio_status;
+            handle->s_gpio_status = s_gpio_status;
             zh_encoder_button_event_on_isr_t encoder_data = {0};
-            encoder_data.encoder_number = encoder_handle->encoder_number;
-            encoder_data.button_status = encoder_handle->s_gpio_status;
-            esp_err_t err = esp_event_isr_post(ZH_ENCODER, ZH_BUTTON_EVENT, &encoder_data, sizeof(zh_encoder_button_event_on_isr_t), &xHigherPriorityTaskWoken);
+            encoder_data.encoder_number = handle->encoder_number;
+            encoder_data.button_status = handle->s_gpio_status;
+            esp_err_t err = _zh_encoder_event_send(handle->event_loop, ZH_BUTTON_EVENT, &encoder_data, sizeof(zh_encoder_button_event_on_isr_t), handle->event_timeout);
             if (err != ESP_OK)
             {
-                ++_stats.event_post_error;
+                __atomic_fetch_add(&_stats.event_post_error, 1, __ATOMIC_RELAXED);
+                ZH_LOGE("Encoder isr processing failed. Failed to post button event.", err);
+            }
+            _zh_encoder_waiter_notify(handle);
+            if (handle->button_gestures == true)
+            {
+                _zh_encoder_gesture_process(handle, s_gpio_status != handle->button_active_low, current_time);
             }
         }
     }
-    encoder_handle->s_gpio_prev_time = _current_us;
+    if (handle->button_deadline != 0 && current_time >= handle->button_deadline)
+    {
+        _zh_encoder_gesture_process(handle, handle->button_state == ZH_ENCODER_BUTTON_STATE_PRESSED || handle->button_state == ZH_ENCODER_BUTTON_STATE_HOLD, current_time);
+    }
+    if (handle->button_debounce_pending == true)
+    {
+        int64_t debounce_deadline = handle->s_gpio_prev_time + handle->s_gpio_debounce_time;
+        return (handle->button_deadline == 0 || debounce_deadline < handle->button_deadline) ? debounce_deadline : handle->button_deadline;
+    }
+    return handle->button_deadline;
+}
+
+static void _zh_encoder_gesture_process(zh_encoder_handle_t *handle, bool is_pressed, int64_t current_time)
+{
+    bool is_timeout = (handle->button_deadline != 0 && current_time >= handle->button_deadline);
+    switch (handle->button_state)
+    {
+    case ZH_ENCODER_BUTTON_STATE_IDLE:
+        if (is_pressed == true)
+        {
+            handle->button_state = ZH_ENCODER_BUTTON_STATE_PRESSED;
+            handle->button_deadline = current_time + handle->button_long_press_time * 1000LL;
+        }
+        break;
+    case ZH_ENCODER_BUTTON_STATE_PRESSED:
+        if (is_pressed == false)
+        {
+            if (handle->button_double_click_time != 0)
+            {
+                handle->button_state = ZH_ENCODER_BUTTON_STATE_RELEASED;
+                handle->button_deadline = current_time + handle->button_double_click_time * 1000LL;
+            }
+            else
+            {
+                _zh_encoder_gesture_post(handle, ZH_ENCODER_GESTURE_CLICK);
+                handle->button_state = ZH_ENCODER_BUTTON_STATE_IDLE;
+                handle->button_deadline = 0;
+            }
+        }
+        else if (is_timeout == true)
+        {
+            handle->button_repeat_count = 0;
+            _zh_encoder_gesture_post(handle, ZH_ENCODER_GESTURE_LONG_PRESS);
+            handle->button_state = ZH_ENCODER_BUTTON_STATE_HOLD;
+            handle->button_deadline = (handle->button_repeat_period != 0) ? current_time + handle->button_repeat_period * 1000LL : 0;
+        }
+        break;
+    case ZH_ENCODER_BUTTON_STATE_HOLD:
+        if (is_pressed == false)
+        {
+            handle->button_state = ZH_ENCODER_BUTTON_STATE_IDLE;
+            handle->button_deadline = 0;
+        }
+        else if (is_timeout == true)
+        {
+            ++handle->button_repeat_count;
+            _zh_encoder_gesture_post(handle, ZH_ENCODER_GESTURE_REPEAT);
+            handle->button_deadline += handle->button_repeat_period * 1000LL;
+            if (handle->button_deadline <= current_time)
+            {
+                handle->button_deadline = current_time + handle->button_repeat_period * 1000LL;
+            }
+        }
+        break;
+    case ZH_ENCODER_BUTTON_STATE_RELEASED:
+        if (is_pressed == true)
+        {
+            handle->button_state = ZH_ENCODER_BUTTON_STATE_SECOND_PRESSED;
+            handle->button_deadline = 0;
+        }
+        else if (is_timeout == true)
+        {
+            _zh_encoder_gesture_post(handle, ZH_ENCODER_GESTURE_CLICK);
+            handle->button_state = ZH_ENCODER_BUTTON_STATE_IDLE;
+            handle->button_deadline = 0;
+        }
+        break;
+    case ZH_ENCODER_BUTTON_STATE_SECOND_PRESSED:
+        if (is_pressed == false)
+        {
+            _zh_encoder_gesture_post(handle, ZH_ENCODER_GESTURE_DOUBLE_CLICK);
+            handle->button_state = ZH_ENCODER_BUTTON_STATE_IDLE;
+        }
+        break;
+    default:
+        handle->button_state = ZH_ENCODER_BUTTON_STATE_IDLE;
+        handle->button_deadline = 0;
+        break;
+    }
+}
+
+static void _zh_encoder_gesture_post(zh_encoder_handle_t *handle, zh_encoder_button_gesture_t gesture)
+{
+    zh_encoder_button_gesture_event_t encoder_data = {0};
+    encoder_data.encoder_number = handle->encoder_number;
+    encoder_data.gesture = gesture;
+    encoder_data.repeat_count = handle->button_repeat_count;
+    esp_err_t err = _zh_encoder_event_send(handle->event_loop, ZH_BUTTON_GESTURE_EVENT, &encoder_data, sizeof(zh_encoder_button_gesture_event_t), handle->event_timeout);
+    if (err != ESP_OK)
+    {
+        __atomic_fetch_add(&_stats.event_post_error, 1, __ATOMIC_RELAXED);
+        ZH_LOGE("Encoder isr processing failed. Failed to post button gesture event.", err);
+    }
+}
+
+static void ZH_ENCODER_ISR_ATTR _zh_encoder_software_isr_handler(void *arg)
+{
+    zh_encoder_handle_t *encoder_handle = (zh_encoder_handle_t *)arg;
+    uint8_t software_state = (gpio_get_level((gpio_num_t)encoder_handle->a_gpio_number) << 1) | gpio_get_level((gpio_num_t)encoder_handle->b_gpio_number);
+    int8_t transition = _transition_table[(encoder_handle->software_state << 2) | software_state];
+    encoder_handle->software_state = software_state;
+    if (transition == 0)
+    {
+        return;
+    }
+    encoder_handle->software_transitions += transition;
+    if (encoder_handle->software_transitions > -encoder_handle->software_step_transitions && encoder_handle->software_transitions < encoder_handle->software_step_transitions)
+    {
+        return;
+    }
+    int steps = (encoder_handle->software_transitions > 0) ? ZH_ENCODER_DIRECTION_CW : ZH_ENCODER_DIRECTION_CCW;
+    encoder_handle->software_transitions = 0;
+    if (_zh_encoder_step_isr(encoder_handle, steps) == true)
+    {
+        portYIELD_FROM_ISR();
+    };
+}
+
+static void _zh_encoder_counter_timer_handler(void *arg)
+{
+    zh_encoder_handle_t *encoder_handle = (zh_encoder_handle_t *)arg;
+    __atomic_store_n(&encoder_handle->counter_update_request, true, __ATOMIC_RELAXED);
+    xTaskNotifyGive(encoder_handle->task_handle);
+}
+
+static void _zh_encoder_deadline_timer_handler(void *arg)
+{
+    zh_encoder_task_group_t *task_group = (zh_encoder_task_group_t *)arg;
+    TaskHandle_t task_handle = __atomic_load_n(&task_group->task_handle, __ATOMIC_ACQUIRE);
+    if (task_handle != NULL)
+    {
+        xTaskNotifyGive(task_handle);
+    }
+}
+
+static void ZH_ENCODER_ISR_ATTR _zh_encoder_index_isr_handler(void *arg)
+{
+    zh_encoder_handle_t *encoder_handle = (zh_encoder_handle_t *)arg;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    _zh_encoder_index_latch(encoder_handle);
+    _zh_encoder_trace_write((uint32_t)esp_timer_get_time(), encoder_handle->encoder_number, ZH_ENCODER_TRACE_INDEX, 0);
+    vTaskNotifyGiveFromISR(encoder_handle->task_handle, &xHigherPriorityTaskWoken);
     if (xHigherPriorityTaskWoken == pdTRUE)
     {
         portYIELD_FROM_ISR();
     };
+}
+
+static void ZH_ENCODER_ISR_ATTR _zh_encoder_index_latch(zh_encoder_handle_t *handle)
+{
+    int count = 0;
+    if (handle->counter_mode == true)
+    {
+        pcnt_unit_get_count(handle->pcnt_unit_handle, &count);
+    }
+    portENTER_CRITICAL_SAFE(&_spinlock);
+    if (handle->counter_mode == true)
+    {
+        handle->index_latch = count;
+    }
+    else if (handle->callback_in_isr == true)
+    {
+        handle->index_latch = handle->encoder_ticks;
+    }
+    else
+    {
+        handle->index_latch = __atomic_load_n(&handle->index_step_total, __ATOMIC_RELAXED);
+    }
+    handle->index_latch_sequence = handle->origin_sequence;
+    ++handle->index_count;
+    portEXIT_CRITICAL_SAFE(&_spinlock);
+    __atomic_store_n(&handle->index_pending, true, __ATOMIC_RELEASE);
+}
+
+static void _zh_encoder_index_process(zh_encoder_handle_t *handle)
+{
+    if (__atomic_exchange_n(&handle->index_pending, false, __ATOMIC_ACQUIRE) == false)
+    {
+        return;
+    }
+    taskENTER_CRITICAL(&_spinlock);
+    uint32_t origin_sequence = handle->origin_sequence;
+    bool is_latch_valid = (handle->index_latch_sequence == origin_sequence);
+    int64_t encoder_ticks = handle->encoder_ticks;
+    int64_t index_ticks = handle->index_latch;
+    if (handle->counter_mode == true)
+    {
+        index_ticks = encoder_ticks + (handle->index_latch - handle->counter_value) / handle->counts_per_step;
+    }
+    else if (handle->callback_in_isr == false)
+    {
+        index_ticks = encoder_ticks + (int32_t)((uint32_t)handle->index_latch - (uint32_t)handle->index_step_applied);
+    }
+    index_ticks = _zh_encoder_ticks_limit(handle, index_ticks);
+    double origin = handle->encoder_origin;
+    float step = handle->encoder_step;
+    float min = handle->encoder_min_value;
+    float max = handle->encoder_max_value;
+    int64_t period_ticks = handle->encoder_max_ticks - handle->encoder_min_ticks + 1;
+    bool is_corrected = (handle->index_homing == true || handle->index_mode == ZH_ENCODER_INDEX_RESET);
+    taskEXIT_CRITICAL(&_spinlock);
+    if (is_latch_valid == false)
+    {
+        return;
+    }
+    float index_encoder_position = _zh_encoder_position_calc(origin, step, min, max, index_ticks);
+    double position_error = (double)index_encoder_position - handle->index_position;
+    double period = (double)period_ticks * step;
+    if (handle->wrap_around == true)
+    {
+        position_error -= round(position_error / period) * period;
+    }
+    double corrected_origin = 0;
+    if (is_corrected == true)
+    {
+        corrected_origin = _zh_encoder_position_calc(origin, step, min, max, encoder_ticks) - position_error;
+        if (handle->wrap_around == true)
+        {
+            corrected_origin -= floor((corrected_origin - min) / period) * period;
+        }
+        if (corrected_origin > max)
+        {
+            corrected_origin = max;
+        }
+        if (corrected_origin < min)
+        {
+            corrected_origin = min;
+        }
+    }
+    zh_encoder_index_event_t encoder_data = {0};
+    taskENTER_CRITICAL(&_spinlock);
+    if (handle->origin_sequence != origin_sequence)
+    {
+        taskEXIT_CRITICAL(&_spinlock);
+        return;
+    }
+    if (is_corrected == true)
+    {
+        int64_t ticks_delta = handle->encoder_ticks - encoder_ticks;
+        _zh_encoder_state_write_begin();
+        _zh_encoder_origin_set(handle, corrected_origin);
+        handle->encoder_ticks = _zh_encoder_ticks_limit(handle, ticks_delta);
+        _zh_encoder_state_write_end();
+        handle->index_homing = false;
+        handle->index_homed = true;
+    }
+    handle->index_corrected = is_corrected;
+    handle->index_encoder_position = index_encoder_position;
+    handle->index_error = (float)position_error;
+    encoder_data.encoder_position = index_encoder_position;
+    encoder_data.position_error = (float)position_error;
+    encoder_data.index_count = handle->index_count;
+    encoder_data.encoder_number = handle->encoder_number;
+    encoder_data.is_homed = handle->index_homed;
+    encoder_data.is_corrected = is_corrected;
+    taskEXIT_CRITICAL(&_spinlock);
+    if (is_corrected == true)
+    {
+        _zh_encoder_persistence_request(handle);
+        _zh_encoder_waiter_notify(handle);
+    }
+    esp_err_t err = _zh_encoder_event_send(handle->event_loop, ZH_INDEX_EVENT, &encoder_data, sizeof(zh_encoder_index_event_t), handle->event_timeout);
+    if (err != ESP_OK)
+    {
+        __atomic_fetch_add(&_stats.event_post_error, 1, __ATOMIC_RELAXED);
+        ZH_LOGE("Encoder isr processing failed. Failed to post index event.", err);
+    }
 }
\ No newline at end of file